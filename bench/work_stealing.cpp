@@ -0,0 +1,178 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../deque.h"
+#include "../matrix.h"
+
+class Scheduler;
+
+class Task {
+public:
+    virtual ~Task() = default;
+
+    virtual void run(Scheduler& scheduler, size_t worker) = 0;
+};
+
+class Scheduler {
+public:
+    explicit Scheduler(size_t number_of_workers);
+
+    void run(Task* root);
+    void spawn(Task* task, size_t worker);
+    void finish();
+
+private:
+    void WorkerLoop(size_t worker);
+
+    std::vector<std::unique_ptr<WorkStealingDeque<Task*>>> deques_;
+    std::atomic<bool> done_;
+};
+
+Scheduler::Scheduler(size_t number_of_workers): done_(false) {
+    for (size_t i = 0; i < number_of_workers; ++i) {
+        deques_.push_back(std::make_unique<WorkStealingDeque<Task*>>());
+    }
+}
+
+void Scheduler::run(Task* root) {
+    done_.store(false, std::memory_order_relaxed);
+    deques_[0]->push_back(root);
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < deques_.size(); ++i) {
+        threads.emplace_back(&Scheduler::WorkerLoop, this, i);
+    }
+    WorkerLoop(0);
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void Scheduler::spawn(Task* task, size_t worker) {
+    deques_[worker]->push_back(task);
+}
+
+void Scheduler::finish() {
+    done_.store(true, std::memory_order_release);
+}
+
+void Scheduler::WorkerLoop(size_t worker) {
+    std::minstd_rand random(worker + 1);
+    Task* task = nullptr;
+
+    while (!done_.load(std::memory_order_acquire)) {
+        if (deques_[worker]->try_pop_back(task)) {
+            task->run(*this, worker);
+            continue;
+        }
+
+        size_t victim = random() % deques_.size();
+        if (victim != worker && deques_[victim]->try_steal(task)) {
+            task->run(*this, worker);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+template <typename Value>
+class ProductTask: public Task {
+public:
+    ProductTask(const std::vector<Value>& values, size_t from, size_t to, size_t grain,
+                Value* result, ProductTask* parent)
+        : values_(values), from_(from), to_(to), grain_(grain), result_(result), parent_(parent), pending_(2) {}
+
+    void run(Scheduler& scheduler, size_t worker) override {
+        if (to_ - from_ <= grain_) {
+            Value product = values_[from_];
+            for (size_t i = from_ + 1; i < to_; ++i) {
+                product *= values_[i];
+            }
+            *result_ = std::move(product);
+            Complete(scheduler);
+
+            return;
+        }
+
+        size_t middle = from_ + (to_ - from_) / 2;
+        left_child_ = std::make_unique<ProductTask>(values_, from_, middle, grain_, &left_, this);
+        right_child_ = std::make_unique<ProductTask>(values_, middle, to_, grain_, &right_, this);
+        scheduler.spawn(right_child_.get(), worker);
+        scheduler.spawn(left_child_.get(), worker);
+    }
+
+private:
+    void Complete(Scheduler& scheduler) {
+        for (ProductTask* task = parent_; task; task = task->parent_) {
+            if (task->pending_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                return;
+            }
+            *task->result_ = task->left_ * task->right_;
+        }
+        scheduler.finish();
+    }
+
+    const std::vector<Value>& values_;
+    size_t from_;
+    size_t to_;
+    size_t grain_;
+    Value* result_;
+    ProductTask* parent_;
+    std::atomic<int> pending_;
+    Value left_;
+    Value right_;
+    std::unique_ptr<ProductTask> left_child_;
+    std::unique_ptr<ProductTask> right_child_;
+};
+
+template <typename Value>
+Value computeProduct(const std::vector<Value>& values, size_t grain, size_t number_of_workers, double& seconds) {
+    Value result;
+    ProductTask<Value> root(values, 0, values.size(), grain, &result, nullptr);
+    Scheduler scheduler(number_of_workers);
+
+    auto start = std::chrono::steady_clock::now();
+    scheduler.run(&root);
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return result;
+}
+
+template <typename Value>
+void benchmark(const std::string& name, const std::vector<Value>& values, size_t grain, size_t max_workers) {
+    double seconds = 0;
+    Value expected = computeProduct(values, grain, 1, seconds);
+    double sequential = seconds;
+
+    for (size_t workers = 1; workers <= max_workers; workers *= 2) {
+        Value result = computeProduct(values, grain, workers, seconds);
+        std::cout << name << " workers=" << workers << " time=" << seconds << "s speedup=" << sequential / seconds
+                  << (result == expected ? "" : " MISMATCH") << '\n';
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t max_workers = argc > 1 ? std::atoi(argv[1]) : std::thread::hardware_concurrency();
+    size_t factorial = argc > 2 ? std::atoi(argv[2]) : 60000;
+    size_t continuants = argc > 3 ? std::atoi(argv[3]) : 20000;
+
+    std::vector<BigInteger> numbers;
+    for (size_t i = 1; i <= factorial; ++i) {
+        numbers.push_back(BigInteger(static_cast<int>(i)));
+    }
+    benchmark("factorial", numbers, 64, max_workers);
+
+    std::vector<Matrix<2, 2, BigInteger>> matrices;
+    for (size_t i = 1; i <= continuants; ++i) {
+        matrices.push_back(Matrix<2, 2, BigInteger>({{BigInteger(static_cast<int>(i)), 1}, {1, 0}}));
+    }
+    benchmark("continuant", matrices, 16, max_workers);
+}
@@ -221,6 +221,24 @@ public:
         return number_.size();
     }
 
+    size_t SizeEstimate() const {
+        static const size_t digit_storage_bits = 30;
+
+        size_t top = Length();
+        while (top > 0 && number_[top - 1] == 0) {
+            --top;
+        }
+        if (top == 0) {
+            return 0;
+        }
+
+        size_t size = (top - 1) * digit_storage_bits;
+        for (long long digit = number_[top - 1]; digit != 0; digit >>= 1) {
+            ++size;
+        }
+        return size;
+    }
+
     BigInteger Abs() const {
         BigInteger copy = *this;
         copy.is_negative_ = false;
@@ -584,6 +602,10 @@ public:
         return numerator_.IsNegative();
     }
 
+    size_t SizeEstimate() const {
+        return numerator_.SizeEstimate() + denominator_.SizeEstimate();
+    }
+
 private:
     BigInteger Max(const BigInteger& first, const BigInteger& second) {
         if (first > second) {
@@ -1,25 +1,65 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+constexpr size_t getDequeBlockSize(size_t element_size) {
+    size_t block_size = 1;
+    while (2 * block_size * element_size <= 4096) {
+        block_size *= 2;
+    }
 
-template <typename T>
+    return block_size;
+}
+
+template <typename T, typename Allocator = std::allocator<T>, size_t BlockSize = getDequeBlockSize(sizeof(T))>
 class Deque {
 private:
+    static_assert(BlockSize != 0 && (BlockSize & (BlockSize - 1)) == 0);
+    static_assert(BlockSize * sizeof(T) >= sizeof(T*));
+
     template <bool is_const>
     class Iterator;
 
+    template <typename Pointer>
+    class Segment;
+
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using map_allocator = typename alloc_traits::template rebind_alloc<T*>;
+    using map_traits = std::allocator_traits<map_allocator>;
+
 public:
     using iterator = Iterator<false>;
     using const_iterator = Iterator<true>;
     using reverse_iterator = std::reverse_iterator<iterator>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using segment = Segment<T*>;
+    using const_segment = Segment<const T*>;
+    using allocator_type = Allocator;
 
     Deque();
     explicit Deque(size_t number_of_elements);
     Deque(size_t number_of_elements, const T& value);
+    explicit Deque(const Allocator& allocator);
+    Deque(size_t number_of_elements, const Allocator& allocator);
+    Deque(size_t number_of_elements, const T& value, const Allocator& allocator);
     Deque(const Deque& other);
+    Deque(Deque&& other) noexcept;
     Deque& operator=(const Deque& other);
+    Deque& operator=(Deque&& other) noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                                             alloc_traits::is_always_equal::value);
     ~Deque();
 
+    Allocator get_allocator() const;
+
     size_t size() const;
+    size_t cache_size() const;
+    void set_cache_size(size_t number_of_blocks);
 
     T& operator[](size_t position);
     const T& operator[](size_t position) const;
@@ -27,10 +67,18 @@ public:
     const T& at(size_t position) const;
 
     void push_back(const T& value);
+    void push_back(T&& value);
     void pop_back();
     void push_front(const T& value);
+    void push_front(T&& value);
     void pop_front();
 
+    template <typename... Args>
+    T& emplace_back(Args&&... args);
+
+    template <typename... Args>
+    T& emplace_front(Args&&... args);
+
     iterator begin();
     iterator end();
     const_iterator begin() const;
@@ -44,213 +92,392 @@ public:
     const_reverse_iterator crbegin() const;
     const_reverse_iterator crend() const;
 
-    void insert(const iterator& it, const T& value);
-    void erase(iterator it);
+    size_t segment_count() const;
+    segment get_segment(size_t index);
+    const_segment get_segment(size_t index) const;
+
+    iterator insert(const iterator& it, const T& value);
+    iterator insert(const iterator& it, T&& value);
+
+    template <typename ForwardIterator>
+    iterator insert(const iterator& it, ForwardIterator first, ForwardIterator last);
+
+    template <typename... Args>
+    iterator emplace(const iterator& it, Args&&... args);
+
+    iterator erase(const iterator& it);
+    iterator erase(const iterator& first, const iterator& last);
+
+    template <typename ForwardIterator>
+    void append(ForwardIterator first, ForwardIterator last);
+
+    template <typename ForwardIterator>
+    void assign(ForwardIterator first, ForwardIterator last);
+
+    void clear();
+    void shrink_to_fit();
 
 private:
     void SetSize();
-    void IncreaseArray(size_t new_number_of_blocks);
+    void Reserve(size_t front_count, size_t back_count);
+    void RelocateArray(size_t new_number_of_blocks, size_t new_first_block);
+    T* GetElement(size_t position) const;
+    void MoveElements(size_t from, size_t to, size_t count);
+
+    template <typename ForwardIterator>
+    ForwardIterator ConstructElements(ForwardIterator first, size_t to, size_t count);
+
+    T** AllocateMap(size_t number_of_blocks);
+    void DeallocateMap(T** map, size_t number_of_blocks);
+    void AllocateBlock(size_t block);
+    void ReleaseBlock(size_t block);
+    void DeallocateBlock(T* block);
+    void TrimCache(size_t number_of_blocks);
+    size_t UsedBlocks() const;
+    void DestroyElements();
     void DeleteArray();
     void CopyArray(const Deque& other);
+    void Reset();
 
-    static const size_t size_of_array_ = 32;
-    static const size_t expansion_koefficient_ = 3;
+    static const size_t size_of_array_ = BlockSize;
+    static const size_t expansion_koefficient_ = 2;
     static const size_t increase_number_ = 1;
+    static const size_t default_cache_size_ = 4;
 
     T** deque_;
     size_t first_element_index_;
     size_t number_of_blocks_;
     size_t deque_size_;
+    T* cache_ = nullptr;
+    size_t cached_blocks_ = 0;
+    size_t cache_size_ = default_cache_size_;
+    Allocator allocator_;
 };
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-class Deque<T>::Iterator {
+class Deque<T, Allocator, BlockSize>::Iterator {
 public:
-    Iterator(typename std::conditional<is_const, T** const, T**>::type it_deque, size_t index);
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = typename std::conditional<is_const, const T*, T*>::type;
+    using reference = typename std::conditional<is_const, const T&, T&>::type;
+
+    Iterator();
+
+    template <bool other_const, typename = typename std::enable_if<is_const && !other_const>::type>
+    Iterator(const Iterator<other_const>& other);
 
     Iterator<is_const>& operator++() &;
     Iterator<is_const> operator++(int) &;
     Iterator<is_const>& operator--() &;
     Iterator<is_const> operator--(int) &;
-    Iterator<is_const>& operator+=(int number);
-    Iterator<is_const>& operator+(int number);
-    Iterator<is_const>& operator-=(int number);
-    Iterator<is_const>& operator-(int number);
-    size_t operator-(const Iterator<is_const>& rhs);
+    Iterator<is_const>& operator+=(difference_type number);
+    Iterator<is_const> operator+(difference_type number) const;
+    Iterator<is_const>& operator-=(difference_type number);
+    Iterator<is_const> operator-(difference_type number) const;
+
+    template <bool other_const>
+    difference_type operator-(const Iterator<other_const>& rhs) const;
+
+    friend Iterator<is_const> operator+(difference_type number, const Iterator<is_const>& it) {
+        return it + number;
+    }
+
+    template <bool other_const>
+    bool operator>(const Iterator<other_const>& rhs) const;
+
+    template <bool other_const>
+    bool operator<(const Iterator<other_const>& rhs) const;
+
+    template <bool other_const>
+    bool operator>=(const Iterator<other_const>& rhs) const;
+
+    template <bool other_const>
+    bool operator<=(const Iterator<other_const>& rhs) const;
 
-    bool operator>(const Iterator<is_const>& rhs);
-    bool operator<(const Iterator<is_const>& rhs);
-    bool operator>=(const Iterator<is_const>& rhs);
-    bool operator<=(const Iterator<is_const>& rhs);
-    bool operator==(const Iterator<is_const>& rhs);
-    bool operator!=(const Iterator<is_const>& rhs);
+    template <bool other_const>
+    bool operator==(const Iterator<other_const>& rhs) const;
 
-    typename std::conditional<is_const, const T&, T&>::type operator*();
-    typename std::conditional<is_const, const T*, T*>::type operator->();
+    template <bool other_const>
+    bool operator!=(const Iterator<other_const>& rhs) const;
 
-    size_t getIndex() const;
+    reference operator*() const;
+    pointer operator->() const;
+    reference operator[](difference_type number) const;
 
 private:
-    static const size_t size_of_array_ = 32;
+    friend class Deque;
 
-    T** it_deque_;
-    size_t index_;
+    template <bool>
+    friend class Iterator;
+
+    Iterator(T** map, size_t index);
+
+    T** block_;
+    T* block_begin_;
+    T* current_;
 };
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-Deque<T>::Iterator<is_const>::Iterator(typename std::conditional<is_const, T** const, T**>::type it_deque, size_t index): it_deque_(it_deque),
-                                                                                                           index_(index) {}
+Deque<T, Allocator, BlockSize>::Iterator<is_const>::Iterator(): block_(nullptr),
+                                                          block_begin_(nullptr),
+                                                          current_(nullptr) {}
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
+template <bool is_const>
+template <bool other_const, typename>
+Deque<T, Allocator, BlockSize>::Iterator<is_const>::Iterator(const Iterator<other_const>& other): block_(other.block_),
+                                                                                             block_begin_(other.block_begin_),
+                                                                                             current_(other.current_) {}
+
+template <typename T, typename Allocator, size_t BlockSize>
+template <bool is_const>
+Deque<T, Allocator, BlockSize>::Iterator<is_const>::Iterator(T** map, size_t index): block_(nullptr),
+                                                                                  block_begin_(nullptr),
+                                                                                  current_(nullptr) {
+    if (map == nullptr) {
+        return;
+    }
+
+    block_ = map + index / size_of_array_;
+    block_begin_ = *block_;
+    if (block_begin_ != nullptr) {
+        current_ = block_begin_ + index % size_of_array_;
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-typename Deque<T>::template Iterator<is_const>& Deque<T>::Iterator<is_const>::operator++() & {
-     ++index_;
+typename Deque<T, Allocator, BlockSize>::template Iterator<is_const>& Deque<T, Allocator, BlockSize>::Iterator<is_const>::operator++() & {
+    ++current_;
+    if (current_ == block_begin_ + size_of_array_) {
+        ++block_;
+        block_begin_ = *block_;
+        current_ = block_begin_;
+    }
+
     return *this;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-typename Deque<T>::template Iterator<is_const> Deque<T>::Iterator<is_const>::operator++(int) & {
+typename Deque<T, Allocator, BlockSize>::template Iterator<is_const> Deque<T, Allocator, BlockSize>::Iterator<is_const>::operator++(int) & {
     Iterator<is_const> it = *this;
     ++*this;
     return it;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-typename Deque<T>::template Iterator<is_const>& Deque<T>::Iterator<is_const>::operator--() & {
-     --index_;
+typename Deque<T, Allocator, BlockSize>::template Iterator<is_const>& Deque<T, Allocator, BlockSize>::Iterator<is_const>::operator--() & {
+    if (current_ == block_begin_) {
+        --block_;
+        block_begin_ = *block_;
+        current_ = block_begin_ + size_of_array_;
+    }
+    --current_;
+
     return *this;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-typename Deque<T>::template Iterator<is_const> Deque<T>::Iterator<is_const>::operator--(int) & {
+typename Deque<T, Allocator, BlockSize>::template Iterator<is_const> Deque<T, Allocator, BlockSize>::Iterator<is_const>::operator--(int) & {
     Iterator<is_const> it = *this;
     --*this;
     return it;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-typename Deque<T>::template Iterator<is_const>& Deque<T>::Iterator<is_const>::operator+=(int number) {
-    index_ += number;
+typename Deque<T, Allocator, BlockSize>::template Iterator<is_const>& Deque<T, Allocator, BlockSize>::Iterator<is_const>::operator+=(difference_type number) {
+    difference_type block_size = size_of_array_;
+    difference_type offset = (current_ - block_begin_) + number;
+    if (offset >= 0 && offset < block_size) {
+        current_ += number;
+        return *this;
+    }
+
+    difference_type block_shift = offset >= 0 ? offset / block_size : -((-offset - 1) / block_size) - 1;
+    block_ += block_shift;
+    block_begin_ = *block_;
+    current_ = block_begin_ == nullptr ? nullptr : block_begin_ + (offset - block_shift * block_size);
+
     return *this;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-typename Deque<T>::template Iterator<is_const>& Deque<T>::Iterator<is_const>::operator+(int number) {
-    *this += number;
-    return *this;
+typename Deque<T, Allocator, BlockSize>::template Iterator<is_const> Deque<T, Allocator, BlockSize>::Iterator<is_const>::operator+(difference_type number) const {
+    Iterator<is_const> it = *this;
+    it += number;
+    return it;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-typename Deque<T>::template Iterator<is_const>& Deque<T>::Iterator<is_const>::operator-=(int number) {
-    index_ -= number;
-    return *this;
+typename Deque<T, Allocator, BlockSize>::template Iterator<is_const>& Deque<T, Allocator, BlockSize>::Iterator<is_const>::operator-=(difference_type number) {
+    return *this += -number;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-typename Deque<T>::template Iterator<is_const>& Deque<T>::Iterator<is_const>::operator-(int number) {
-    *this -= number;
-    return *this;
+typename Deque<T, Allocator, BlockSize>::template Iterator<is_const> Deque<T, Allocator, BlockSize>::Iterator<is_const>::operator-(difference_type number) const {
+    Iterator<is_const> it = *this;
+    it -= number;
+    return it;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-size_t Deque<T>::Iterator<is_const>::operator-(const Iterator<is_const>& rhs) {
-    return index_ - rhs.index_;
+template <bool other_const>
+typename Deque<T, Allocator, BlockSize>::template Iterator<is_const>::difference_type Deque<T, Allocator, BlockSize>::Iterator<is_const>::operator-(const Iterator<other_const>& rhs) const {
+    return (block_ - rhs.block_) * static_cast<difference_type>(size_of_array_) +
+           (current_ - block_begin_) - (rhs.current_ - rhs.block_begin_);
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-bool Deque<T>::Iterator<is_const>::operator>(const Iterator<is_const>& rhs) {
-    return index_ > rhs.index_;
+template <bool other_const>
+bool Deque<T, Allocator, BlockSize>::Iterator<is_const>::operator>(const Iterator<other_const>& rhs) const {
+    return rhs < *this;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-bool Deque<T>::Iterator<is_const>::operator<(const Iterator<is_const>& rhs) {
-    return index_ < rhs.index_;
+template <bool other_const>
+bool Deque<T, Allocator, BlockSize>::Iterator<is_const>::operator<(const Iterator<other_const>& rhs) const {
+    return block_ == rhs.block_ ? current_ < rhs.current_ : block_ < rhs.block_;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-bool Deque<T>::Iterator<is_const>::operator==(const Iterator<is_const>& rhs) {
-    return index_ ==  rhs.index_;
+template <bool other_const>
+bool Deque<T, Allocator, BlockSize>::Iterator<is_const>::operator==(const Iterator<other_const>& rhs) const {
+    return current_ == rhs.current_ && block_ == rhs.block_;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-bool Deque<T>::Iterator<is_const>::operator>=(const Iterator<is_const>& rhs) {
-    return index_ >= rhs.index_;
+template <bool other_const>
+bool Deque<T, Allocator, BlockSize>::Iterator<is_const>::operator>=(const Iterator<other_const>& rhs) const {
+    return !(*this < rhs);
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-bool Deque<T>::Iterator<is_const>::operator<=(const Iterator<is_const>& rhs) {
-    return index_ <= rhs.index_;
+template <bool other_const>
+bool Deque<T, Allocator, BlockSize>::Iterator<is_const>::operator<=(const Iterator<other_const>& rhs) const {
+    return !(rhs < *this);
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-bool Deque<T>::Iterator<is_const>::operator!=(const Iterator<is_const>& rhs) {
-    return index_ != rhs.index_;
+template <bool other_const>
+bool Deque<T, Allocator, BlockSize>::Iterator<is_const>::operator!=(const Iterator<other_const>& rhs) const {
+    return !(*this == rhs);
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-typename std::conditional<is_const, const T&, T&>::type Deque<T>::Iterator<is_const>::operator*() {
-    return it_deque_[index_ / size_of_array_][index_ % size_of_array_];
+typename Deque<T, Allocator, BlockSize>::template Iterator<is_const>::reference Deque<T, Allocator, BlockSize>::Iterator<is_const>::operator*() const {
+    return *current_;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-typename std::conditional<is_const, const T*, T*>::type Deque<T>::Iterator<is_const>::operator->() {
-    return it_deque_[index_ / size_of_array_] + index_ % size_of_array_;
+typename Deque<T, Allocator, BlockSize>::template Iterator<is_const>::pointer Deque<T, Allocator, BlockSize>::Iterator<is_const>::operator->() const {
+    return current_;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BlockSize>
 template <bool is_const>
-size_t Deque<T>::Iterator<is_const>::getIndex() const {
-    return index_;
+typename Deque<T, Allocator, BlockSize>::template Iterator<is_const>::reference Deque<T, Allocator, BlockSize>::Iterator<is_const>::operator[](difference_type number) const {
+    return *(*this + number);
 }
 
-template <typename T>
-Deque<T>::Deque(): first_element_index_(0),
-                   number_of_blocks_(1),
-                   deque_size_(0)
-{
-    SetSize();
+template <typename T, typename Allocator, size_t BlockSize>
+template <typename Pointer>
+class Deque<T, Allocator, BlockSize>::Segment {
+public:
+    Segment(Pointer begin, Pointer end);
+
+    Pointer begin() const;
+    Pointer end() const;
+    size_t size() const;
+
+private:
+    Pointer begin_;
+    Pointer end_;
+};
+
+template <typename T, typename Allocator, size_t BlockSize>
+template <typename Pointer>
+Deque<T, Allocator, BlockSize>::Segment<Pointer>::Segment(Pointer begin, Pointer end): begin_(begin),
+                                                                              end_(end) {}
+
+template <typename T, typename Allocator, size_t BlockSize>
+template <typename Pointer>
+Pointer Deque<T, Allocator, BlockSize>::Segment<Pointer>::begin() const {
+    return begin_;
 }
 
-template <typename T>
-Deque<T>::Deque(size_t number_of_elements): first_element_index_(0),
+template <typename T, typename Allocator, size_t BlockSize>
+template <typename Pointer>
+Pointer Deque<T, Allocator, BlockSize>::Segment<Pointer>::end() const {
+    return end_;
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+template <typename Pointer>
+size_t Deque<T, Allocator, BlockSize>::Segment<Pointer>::size() const {
+    return end_ - begin_;
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+Deque<T, Allocator, BlockSize>::Deque(): Deque(Allocator()) {}
+
+template <typename T, typename Allocator, size_t BlockSize>
+Deque<T, Allocator, BlockSize>::Deque(size_t number_of_elements): Deque(number_of_elements, Allocator()) {}
+
+template <typename T, typename Allocator, size_t BlockSize>
+Deque<T, Allocator, BlockSize>::Deque(size_t number_of_elements, const T& value): Deque(number_of_elements, value, Allocator()) {}
+
+template <typename T, typename Allocator, size_t BlockSize>
+Deque<T, Allocator, BlockSize>::Deque(const Allocator& allocator): deque_(nullptr),
+                                                        first_element_index_(0),
+                                                        number_of_blocks_(0),
+                                                        deque_size_(0),
+                                                        allocator_(allocator) {}
+
+template <typename T, typename Allocator, size_t BlockSize>
+Deque<T, Allocator, BlockSize>::Deque(size_t number_of_elements, const Allocator& allocator): first_element_index_(0),
                                   number_of_blocks_(number_of_elements / size_of_array_ + 1),
-                                  deque_size_(0)
+                                  deque_size_(0),
+                                  allocator_(allocator)
 {
     SetSize();
 
     for (size_t i = 0; i < number_of_elements; ++i) {
         try {
-            push_back(T());
+            emplace_back();
         } catch(...) {
-            pop_back();
+            DeleteArray();
+            TrimCache(0);
 
             throw;
         }
     }
 }
 
-template <typename T>
-Deque<T>::Deque(size_t number_of_elements, const T& value): first_element_index_(0),
+template <typename T, typename Allocator, size_t BlockSize>
+Deque<T, Allocator, BlockSize>::Deque(size_t number_of_elements, const T& value, const Allocator& allocator): first_element_index_(0),
                                                   number_of_blocks_(number_of_elements / size_of_array_ + 1),
-                                                  deque_size_(0)
+                                                  deque_size_(0),
+                                                  allocator_(allocator)
 {
     SetSize();
 
@@ -258,28 +485,48 @@ Deque<T>::Deque(size_t number_of_elements, const T& value): first_element_index_
         try {
             push_back(value);
         } catch(...) {
-            pop_back();
+            DeleteArray();
+            TrimCache(0);
 
             throw;
         }
     }
 }
 
-template <typename T>
-Deque<T>::Deque(const Deque& other): first_element_index_(other.first_element_index_),
+template <typename T, typename Allocator, size_t BlockSize>
+Deque<T, Allocator, BlockSize>::Deque(const Deque& other): first_element_index_(other.first_element_index_),
                            number_of_blocks_(other.number_of_blocks_),
-                           deque_size_(other.deque_size_)
+                           deque_size_(other.deque_size_),
+                           cache_size_(other.cache_size_),
+                           allocator_(alloc_traits::select_on_container_copy_construction(other.allocator_))
 {
     CopyArray(other);
 }
 
-template <typename T>
-typename Deque<T>::Deque& Deque<T>::operator=(const Deque& other) {
-    if (deque_ == other.deque_) {
+template <typename T, typename Allocator, size_t BlockSize>
+Deque<T, Allocator, BlockSize>::Deque(Deque&& other) noexcept: deque_(other.deque_),
+                                         first_element_index_(other.first_element_index_),
+                                         number_of_blocks_(other.number_of_blocks_),
+                                         deque_size_(other.deque_size_),
+                                         cache_(other.cache_),
+                                         cached_blocks_(other.cached_blocks_),
+                                         cache_size_(other.cache_size_),
+                                         allocator_(std::move(other.allocator_))
+{
+    other.Reset();
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::Deque& Deque<T, Allocator, BlockSize>::operator=(const Deque& other) {
+    if (this == &other) {
         return *this;
     }
 
     DeleteArray();
+    if (alloc_traits::propagate_on_container_copy_assignment::value) {
+        TrimCache(0);
+        allocator_ = other.allocator_;
+    }
 
     CopyArray(other);
 
@@ -290,30 +537,83 @@ typename Deque<T>::Deque& Deque<T>::operator=(const Deque& other) {
     return *this;
 }
 
-template <typename T>
-Deque<T>::~Deque() {
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::Deque& Deque<T, Allocator, BlockSize>::operator=(Deque&& other)
+    noexcept(alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
+    if (this == &other) {
+        return *this;
+    }
+
+    if (!alloc_traits::propagate_on_container_move_assignment::value && !(allocator_ == other.allocator_)) {
+        clear();
+        for (size_t i = 0; i < other.deque_size_; ++i) {
+            emplace_back(std::move(other[i]));
+        }
+        other.clear();
+
+        return *this;
+    }
+
+    DeleteArray();
+    TrimCache(0);
+    if (alloc_traits::propagate_on_container_move_assignment::value) {
+        allocator_ = other.allocator_;
+    }
+
+    deque_ = other.deque_;
+    first_element_index_ = other.first_element_index_;
+    number_of_blocks_ = other.number_of_blocks_;
+    deque_size_ = other.deque_size_;
+    cache_ = other.cache_;
+    cached_blocks_ = other.cached_blocks_;
+    cache_size_ = other.cache_size_;
+
+    other.Reset();
+
+    return *this;
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+Deque<T, Allocator, BlockSize>::~Deque() {
     DeleteArray();
+    TrimCache(0);
 }
 
-template <typename T>
-size_t Deque<T>::size() const {
+template <typename T, typename Allocator, size_t BlockSize>
+Allocator Deque<T, Allocator, BlockSize>::get_allocator() const {
+    return allocator_;
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+size_t Deque<T, Allocator, BlockSize>::size() const {
     return deque_size_;
 }
 
-template <typename T>
-T& Deque<T>::operator[](size_t position) {
+template <typename T, typename Allocator, size_t BlockSize>
+size_t Deque<T, Allocator, BlockSize>::cache_size() const {
+    return cache_size_;
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::set_cache_size(size_t number_of_blocks) {
+    cache_size_ = number_of_blocks;
+    TrimCache(cache_size_);
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+T& Deque<T, Allocator, BlockSize>::operator[](size_t position) {
     size_t index = first_element_index_ + position;
     return deque_[index / size_of_array_][index % size_of_array_];
 }
 
-template <typename T>
-const T& Deque<T>::operator[](size_t position) const{
+template <typename T, typename Allocator, size_t BlockSize>
+const T& Deque<T, Allocator, BlockSize>::operator[](size_t position) const{
     size_t index = first_element_index_ + position;
     return deque_[index / size_of_array_][index % size_of_array_];
 }
 
-template <typename T>
-T& Deque<T>::at(size_t position) {
+template <typename T, typename Allocator, size_t BlockSize>
+T& Deque<T, Allocator, BlockSize>::at(size_t position) {
     if (position >= deque_size_) {
         throw std::out_of_range("INDEX OUT OF RANGE");
     }
@@ -322,8 +622,8 @@ T& Deque<T>::at(size_t position) {
     return deque_[index / size_of_array_][index % size_of_array_];
 }
 
-template <typename T>
-const T& Deque<T>::at(size_t position) const {
+template <typename T, typename Allocator, size_t BlockSize>
+const T& Deque<T, Allocator, BlockSize>::at(size_t position) const {
     if (position >= deque_size_) {
         throw std::out_of_range("INDEX OUT OF RANGE");
     }
@@ -332,202 +632,923 @@ const T& Deque<T>::at(size_t position) const {
     return deque_[index / size_of_array_][index % size_of_array_];
 }
 
-template <typename T>
-void Deque<T>::push_back(const T& value) {
-    if (first_element_index_ + deque_size_ == size_of_array_ * number_of_blocks_) {
-        IncreaseArray(expansion_koefficient_ * number_of_blocks_);
-    }
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::push_back(const T& value) {
+    emplace_back(value);
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::push_back(T&& value) {
+    emplace_back(std::move(value));
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+template <typename... Args>
+T& Deque<T, Allocator, BlockSize>::emplace_back(Args&&... args) {
+    Reserve(0, 1);
 
     size_t new_element_index = first_element_index_ + deque_size_;
-    try {
-        new(deque_[new_element_index / size_of_array_] + new_element_index % size_of_array_) T(value);
-        ++deque_size_;
-    } catch(...) {
-        deque_[new_element_index / size_of_array_][new_element_index % size_of_array_].~T();
+    T* element = deque_[new_element_index / size_of_array_] + new_element_index % size_of_array_;
+    alloc_traits::construct(allocator_, element, std::forward<Args>(args)...);
+    ++deque_size_;
 
-        throw;
-    }
+    return *element;
 }
 
-template <typename T>
-void Deque<T>::pop_back() {
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::pop_back() {
     size_t last_element_index = first_element_index_ + deque_size_ - 1;
-    (deque_[last_element_index / size_of_array_] + last_element_index % size_of_array_)->~T();
+    alloc_traits::destroy(allocator_, deque_[last_element_index / size_of_array_] + last_element_index % size_of_array_);
 
     --deque_size_;
+    if (last_element_index % size_of_array_ == 0) {
+        ReleaseBlock(last_element_index / size_of_array_);
+    }
 }
 
-template <typename T>
-void Deque<T>::push_front(const T& value) {
-    if (first_element_index_ == 0) {
-        IncreaseArray(expansion_koefficient_ * number_of_blocks_);
-    }
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::push_front(const T& value) {
+    emplace_front(value);
+}
 
-    try {
-        ++deque_size_;
-        --first_element_index_;
-        new(deque_[first_element_index_ / size_of_array_] + first_element_index_ % size_of_array_) T(value);
-    } catch(...) {
-        deque_[first_element_index_ / size_of_array_][first_element_index_ % size_of_array_].~T();
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::push_front(T&& value) {
+    emplace_front(std::move(value));
+}
 
-        throw;
-    }
+template <typename T, typename Allocator, size_t BlockSize>
+template <typename... Args>
+T& Deque<T, Allocator, BlockSize>::emplace_front(Args&&... args) {
+    Reserve(1, 0);
+
+    size_t new_element_index = first_element_index_ - 1;
+    T* element = deque_[new_element_index / size_of_array_] + new_element_index % size_of_array_;
+    alloc_traits::construct(allocator_, element, std::forward<Args>(args)...);
+    first_element_index_ = new_element_index;
+    ++deque_size_;
+
+    return *element;
 }
 
-template <typename T>
-void Deque<T>::pop_front() {
-    (deque_[first_element_index_ / size_of_array_] + first_element_index_ % size_of_array_)->~T();
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::pop_front() {
+    alloc_traits::destroy(allocator_, deque_[first_element_index_ / size_of_array_] + first_element_index_ % size_of_array_);
 
     ++first_element_index_;
     --deque_size_;
+    if (first_element_index_ % size_of_array_ == 0) {
+        ReleaseBlock(first_element_index_ / size_of_array_ - 1);
+    }
 }
 
-template <typename T>
-typename Deque<T>::iterator Deque<T>::begin() {
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::iterator Deque<T, Allocator, BlockSize>::begin() {
     return iterator(deque_, first_element_index_);
 }
 
-template <typename T>
-typename Deque<T>::iterator Deque<T>::end() {
-    iterator it(deque_, first_element_index_);
-    it += deque_size_;
-    return it;
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::iterator Deque<T, Allocator, BlockSize>::end() {
+    return iterator(deque_, first_element_index_ + deque_size_);
 }
 
-template <typename T>
-typename Deque<T>::const_iterator Deque<T>::begin() const {
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::const_iterator Deque<T, Allocator, BlockSize>::begin() const {
     return const_iterator(deque_, first_element_index_);
 }
 
-template <typename T>
-typename Deque<T>::const_iterator Deque<T>::end() const {
-    const_iterator it(deque_, first_element_index_);
-    it += deque_size_;
-    return it;
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::const_iterator Deque<T, Allocator, BlockSize>::end() const {
+    return const_iterator(deque_, first_element_index_ + deque_size_);
 }
 
-template <typename T>
-typename Deque<T>::const_iterator Deque<T>::cbegin() const {
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::const_iterator Deque<T, Allocator, BlockSize>::cbegin() const {
     return const_iterator(deque_, first_element_index_);
 }
 
-template <typename T>
-typename Deque<T>::const_iterator Deque<T>::cend() const {
-    const_iterator it(deque_, first_element_index_);
-    it += deque_size_;
-    return it;
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::const_iterator Deque<T, Allocator, BlockSize>::cend() const {
+    return const_iterator(deque_, first_element_index_ + deque_size_);
 }
 
-template <typename T>
-typename Deque<T>::reverse_iterator Deque<T>::rbegin() {
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::reverse_iterator Deque<T, Allocator, BlockSize>::rbegin() {
     return reverse_iterator(end());
 }
 
-template <typename T>
-typename Deque<T>::reverse_iterator Deque<T>::rend() {
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::reverse_iterator Deque<T, Allocator, BlockSize>::rend() {
     return reverse_iterator(begin());
 }
 
-template <typename T>
-typename Deque<T>::const_reverse_iterator Deque<T>::rbegin() const {
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::const_reverse_iterator Deque<T, Allocator, BlockSize>::rbegin() const {
     return const_reverse_iterator(cend());
 }
 
-template <typename T>
-typename Deque<T>::const_reverse_iterator Deque<T>::rend() const {
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::const_reverse_iterator Deque<T, Allocator, BlockSize>::rend() const {
     return const_reverse_iterator(cbegin());
 }
 
-template <typename T>
-typename Deque<T>::const_reverse_iterator Deque<T>::crbegin() const {
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::const_reverse_iterator Deque<T, Allocator, BlockSize>::crbegin() const {
     return const_reverse_iterator(cend());
 }
 
-template <typename T>
-typename Deque<T>::const_reverse_iterator Deque<T>::crend() const {
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::const_reverse_iterator Deque<T, Allocator, BlockSize>::crend() const {
     return const_reverse_iterator(cbegin());
 }
 
-template <typename T>
-void Deque<T>::insert(const iterator& it, const T& value) {
-   if (first_element_index_ + deque_size_ == size_of_array_ * number_of_blocks_) {
-        IncreaseArray(expansion_koefficient_ * number_of_blocks_);
-   }
+template <typename T, typename Allocator, size_t BlockSize>
+size_t Deque<T, Allocator, BlockSize>::segment_count() const {
+    return UsedBlocks();
+}
 
-   size_t index = deque_size_ + first_element_index_;
-   for (size_t i = index; i > it.getIndex(); --i) {
-       deque_[i / size_of_array_][i % size_of_array_] = \
-       deque_[(i - increase_number_) / size_of_array_][(i - increase_number_) % size_of_array_];
-   }
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::segment Deque<T, Allocator, BlockSize>::get_segment(size_t index) {
+    const_segment current = static_cast<const Deque&>(*this).get_segment(index);
+    return segment(const_cast<T*>(current.begin()), const_cast<T*>(current.end()));
+}
 
-   deque_[it.getIndex() / size_of_array_][it.getIndex() % size_of_array_] = value;
-   ++deque_size_;
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::const_segment Deque<T, Allocator, BlockSize>::get_segment(size_t index) const {
+    size_t first_block = first_element_index_ / size_of_array_;
+    size_t last_element_index = first_element_index_ + deque_size_ - 1;
+    const T* block = deque_[first_block + index];
+    size_t begin = index == 0 ? first_element_index_ % size_of_array_ : 0;
+    size_t end = first_block + index == last_element_index / size_of_array_ ?
+                 last_element_index % size_of_array_ + 1 : size_of_array_;
+
+    return const_segment(block + begin, block + end);
 }
 
-template <typename T>
-void Deque<T>::erase(iterator it) {
-    for (size_t i = it.getIndex(); i < first_element_index_ + deque_size_ - increase_number_; ++i) {
-        deque_[i / size_of_array_][i % size_of_array_] = \
-        deque_[(i + increase_number_) / size_of_array_][(i + increase_number_) % size_of_array_];
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::iterator Deque<T, Allocator, BlockSize>::insert(const iterator& it, const T& value) {
+    return emplace(it, value);
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::iterator Deque<T, Allocator, BlockSize>::insert(const iterator& it, T&& value) {
+    return emplace(it, std::move(value));
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+template <typename ForwardIterator>
+typename Deque<T, Allocator, BlockSize>::iterator Deque<T, Allocator, BlockSize>::insert(const iterator& it, ForwardIterator first, ForwardIterator last) {
+    size_t position = it - begin();
+    size_t count = std::distance(first, last);
+    if (count == 0) {
+        return begin() + position;
     }
 
-    size_t index = first_element_index_ + deque_size_ - increase_number_;
-    deque_[index / size_of_array_][index % size_of_array_].~T();
-    --deque_size_;
+    if (position < deque_size_ - position) {
+        Reserve(count, 0);
+        first_element_index_ -= count;
+        try {
+            ConstructElements(first, 0, count);
+        } catch(...) {
+            first_element_index_ += count;
+
+            throw;
+        }
+        deque_size_ += count;
+
+        std::rotate(begin(), begin() + count, begin() + count + position);
+    } else {
+        Reserve(0, count);
+        ConstructElements(first, deque_size_, count);
+        deque_size_ += count;
+
+        std::rotate(begin() + position, begin() + (deque_size_ - count), end());
+    }
+
+    return begin() + position;
 }
 
-template <typename T>
-void Deque<T>::SetSize() {
-    deque_ = new T*[number_of_blocks_];
+template <typename T, typename Allocator, size_t BlockSize>
+template <typename... Args>
+typename Deque<T, Allocator, BlockSize>::iterator Deque<T, Allocator, BlockSize>::emplace(const iterator& it, Args&&... args) {
+    size_t position = it - begin();
+    if (position < deque_size_ - position) {
+        emplace_front(std::forward<Args>(args)...);
+        if (position > 0) {
+            T element = std::move(*GetElement(0));
+            MoveElements(1, 0, position);
+            *GetElement(position) = std::move(element);
+        }
+    } else {
+        emplace_back(std::forward<Args>(args)...);
+        size_t tail = deque_size_ - 1 - position;
+        if (tail > 0) {
+            T element = std::move(*GetElement(deque_size_ - 1));
+            MoveElements(position, position + 1, tail);
+            *GetElement(position) = std::move(element);
+        }
+    }
+
+    return begin() + position;
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::iterator Deque<T, Allocator, BlockSize>::erase(const iterator& it) {
+    return erase(it, it + 1);
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::iterator Deque<T, Allocator, BlockSize>::erase(const iterator& first, const iterator& last) {
+    size_t position = first - begin();
+    size_t count = last - first;
+    if (count == 0) {
+        return begin() + position;
+    }
+
+    if (position < deque_size_ - position - count) {
+        MoveElements(0, count, position);
+        for (size_t i = 0; i < count; ++i) {
+            pop_front();
+        }
+    } else {
+        MoveElements(position + count, position, deque_size_ - position - count);
+        for (size_t i = 0; i < count; ++i) {
+            pop_back();
+        }
+    }
+
+    return begin() + position;
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+template <typename ForwardIterator>
+void Deque<T, Allocator, BlockSize>::append(ForwardIterator first, ForwardIterator last) {
+    insert(end(), first, last);
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+template <typename ForwardIterator>
+void Deque<T, Allocator, BlockSize>::assign(ForwardIterator first, ForwardIterator last) {
+    clear();
+    insert(end(), first, last);
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::clear() {
+    DestroyElements();
 
     for (size_t i = 0; i < number_of_blocks_; ++i) {
-        deque_[i] = reinterpret_cast<T*>(new uint8_t[size_of_array_ * sizeof(T)]);
+        ReleaseBlock(i);
     }
+
+    first_element_index_ = number_of_blocks_ * size_of_array_ / 2;
+    deque_size_ = 0;
 }
 
-template <typename T>
-void Deque<T>::IncreaseArray(size_t new_number_of_blocks) {
-    T** new_deque = new T*[new_number_of_blocks];
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::shrink_to_fit() {
+    TrimCache(0);
 
-    size_t new_first_element_index = first_element_index_ + number_of_blocks_ * size_of_array_;
-    for (size_t i = 0; i < new_number_of_blocks; ++i) {
-        if (i >= number_of_blocks_ && i < 2 * number_of_blocks_) {
-            new_deque[i] = deque_[i - number_of_blocks_];
-        }
-        else {
-            new_deque[i] = reinterpret_cast<T*>(new uint8_t[size_of_array_ * sizeof(T)]);
+    size_t used_blocks = UsedBlocks();
+    size_t first_block = used_blocks == 0 ? 0 : first_element_index_ / size_of_array_;
+    T** new_deque = used_blocks == 0 ? nullptr : AllocateMap(used_blocks);
+    for (size_t i = 0; i < number_of_blocks_; ++i) {
+        if (i >= first_block && i < first_block + used_blocks) {
+            new_deque[i - first_block] = deque_[i];
+        } else {
+            DeallocateBlock(deque_[i]);
         }
     }
 
-    delete[] deque_;
+    DeallocateMap(deque_, number_of_blocks_);
 
     deque_ = new_deque;
-    first_element_index_ = new_first_element_index;
-    number_of_blocks_ = new_number_of_blocks;
+    first_element_index_ = used_blocks == 0 ? 0 : first_element_index_ % size_of_array_;
+    number_of_blocks_ = used_blocks;
 }
 
-template <typename T>
-void Deque<T>::DeleteArray() {
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::SetSize() {
+    deque_ = AllocateMap(number_of_blocks_);
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::Reserve(size_t front_count, size_t back_count) {
+    if (first_element_index_ < front_count ||
+        number_of_blocks_ * size_of_array_ - first_element_index_ - deque_size_ < back_count) {
+        size_t used_blocks = UsedBlocks();
+        size_t offset = deque_size_ == 0 ? 0 : first_element_index_ % size_of_array_;
+        size_t tail = used_blocks * size_of_array_ - offset - deque_size_;
+        size_t front_blocks = front_count > offset ? (front_count - offset + size_of_array_ - 1) / size_of_array_ : 0;
+        size_t back_blocks = back_count > tail ? (back_count - tail + size_of_array_ - 1) / size_of_array_ : 0;
+        size_t required_blocks = front_blocks + used_blocks + back_blocks;
+
+        size_t new_number_of_blocks = number_of_blocks_;
+        if (2 * required_blocks > number_of_blocks_) {
+            new_number_of_blocks = expansion_koefficient_ * number_of_blocks_ + increase_number_;
+            if (new_number_of_blocks < expansion_koefficient_ * required_blocks + increase_number_) {
+                new_number_of_blocks = expansion_koefficient_ * required_blocks + increase_number_;
+            }
+        }
+        RelocateArray(new_number_of_blocks, front_blocks + (new_number_of_blocks - required_blocks) / 2);
+    }
+
+    for (size_t i = first_element_index_ - front_count; i < first_element_index_; i += size_of_array_ - i % size_of_array_) {
+        AllocateBlock(i / size_of_array_);
+    }
+    size_t end = first_element_index_ + deque_size_;
+    for (size_t i = end; i < end + back_count; i += size_of_array_ - i % size_of_array_) {
+        AllocateBlock(i / size_of_array_);
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::RelocateArray(size_t new_number_of_blocks, size_t new_first_block) {
+    size_t used_blocks = UsedBlocks();
+    size_t first_block = first_element_index_ / size_of_array_;
+    size_t offset = deque_size_ == 0 ? 0 : first_element_index_ % size_of_array_;
+
+    if (new_number_of_blocks == number_of_blocks_) {
+        size_t shift = (first_block + number_of_blocks_ - new_first_block) % number_of_blocks_;
+        std::rotate(deque_, deque_ + shift, deque_ + number_of_blocks_);
+    } else {
+        T** new_deque = AllocateMap(new_number_of_blocks);
+        for (size_t i = 0; i < number_of_blocks_; ++i) {
+            if (i >= first_block && i < first_block + used_blocks) {
+                new_deque[new_first_block + i - first_block] = deque_[i];
+            } else {
+                ReleaseBlock(i);
+            }
+        }
+
+        DeallocateMap(deque_, number_of_blocks_);
+
+        deque_ = new_deque;
+        number_of_blocks_ = new_number_of_blocks;
+    }
+
+    first_element_index_ = new_first_block * size_of_array_ + offset;
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+T* Deque<T, Allocator, BlockSize>::GetElement(size_t position) const {
+    size_t index = first_element_index_ + position;
+    return deque_[index / size_of_array_] + index % size_of_array_;
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::MoveElements(size_t from, size_t to, size_t count) {
+    if (from == to) {
+        return;
+    }
+
+    for (size_t done = 0; done < count;) {
+        size_t source = from < to ? first_element_index_ + from + count - done : first_element_index_ + from + done;
+        size_t target = from < to ? first_element_index_ + to + count - done : first_element_index_ + to + done;
+        size_t source_room = from < to ? (source - 1) % size_of_array_ + 1 : size_of_array_ - source % size_of_array_;
+        size_t target_room = from < to ? (target - 1) % size_of_array_ + 1 : size_of_array_ - target % size_of_array_;
+        size_t chunk = std::min(count - done, std::min(source_room, target_room));
+
+        T* source_begin = from < to ? deque_[(source - 1) / size_of_array_] + (source - 1) % size_of_array_ + 1 - chunk :
+                                      deque_[source / size_of_array_] + source % size_of_array_;
+        T* target_begin = from < to ? deque_[(target - 1) / size_of_array_] + (target - 1) % size_of_array_ + 1 - chunk :
+                                      deque_[target / size_of_array_] + target % size_of_array_;
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            std::memmove(static_cast<void*>(target_begin), source_begin, chunk * sizeof(T));
+        } else if (from < to) {
+            std::move_backward(source_begin, source_begin + chunk, target_begin + chunk);
+        } else {
+            std::move(source_begin, source_begin + chunk, target_begin);
+        }
+        done += chunk;
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+template <typename ForwardIterator>
+ForwardIterator Deque<T, Allocator, BlockSize>::ConstructElements(ForwardIterator first, size_t to, size_t count) {
+    size_t done = 0;
+    try {
+        while (done < count) {
+            size_t target = first_element_index_ + to + done;
+            size_t chunk = std::min(count - done, size_of_array_ - target % size_of_array_);
+
+            T* target_begin = deque_[target / size_of_array_] + target % size_of_array_;
+            for (size_t i = 0; i < chunk; ++i, ++first, ++done) {
+                alloc_traits::construct(allocator_, target_begin + i, *first);
+            }
+        }
+    } catch(...) {
+        for (size_t i = 0; i < done; ++i) {
+            alloc_traits::destroy(allocator_, GetElement(to + i));
+        }
+
+        throw;
+    }
+
+    return first;
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+T** Deque<T, Allocator, BlockSize>::AllocateMap(size_t number_of_blocks) {
+    map_allocator allocator(allocator_);
+    T** map = map_traits::allocate(allocator, number_of_blocks + 1);
+    std::fill(map, map + number_of_blocks + 1, nullptr);
+
+    return map;
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::DeallocateMap(T** map, size_t number_of_blocks) {
+    if (map == nullptr) {
+        return;
+    }
+
+    map_allocator allocator(allocator_);
+    map_traits::deallocate(allocator, map, number_of_blocks + 1);
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::AllocateBlock(size_t block) {
+    if (deque_[block] != nullptr) {
+        return;
+    }
+
+    if (cache_ != nullptr) {
+        deque_[block] = cache_;
+        std::memcpy(&cache_, cache_, sizeof(T*));
+        --cached_blocks_;
+    } else {
+        deque_[block] = alloc_traits::allocate(allocator_, size_of_array_);
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::ReleaseBlock(size_t block) {
+    if (deque_[block] == nullptr) {
+        return;
+    }
+
+    if (cached_blocks_ < cache_size_) {
+        std::memcpy(static_cast<void*>(deque_[block]), &cache_, sizeof(T*));
+        cache_ = deque_[block];
+        ++cached_blocks_;
+    } else {
+        DeallocateBlock(deque_[block]);
+    }
+
+    deque_[block] = nullptr;
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::DeallocateBlock(T* block) {
+    if (block != nullptr) {
+        alloc_traits::deallocate(allocator_, block, size_of_array_);
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::TrimCache(size_t number_of_blocks) {
+    while (cached_blocks_ > number_of_blocks) {
+        T* block = cache_;
+        std::memcpy(&cache_, block, sizeof(T*));
+        DeallocateBlock(block);
+        --cached_blocks_;
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+size_t Deque<T, Allocator, BlockSize>::UsedBlocks() const {
+    if (deque_size_ == 0) {
+        return 0;
+    }
+
+    return (first_element_index_ + deque_size_ - 1) / size_of_array_ - first_element_index_ / size_of_array_ + 1;
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::DestroyElements() {
     for (size_t i = first_element_index_; i < deque_size_ + first_element_index_; ++i) {
-        (deque_[i / size_of_array_] + i % size_of_array_)->~T();
+        alloc_traits::destroy(allocator_, deque_[i / size_of_array_] + i % size_of_array_);
     }
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::DeleteArray() {
+    DestroyElements();
 
     for (size_t i = 0; i < number_of_blocks_; ++i) {
-        delete[] reinterpret_cast<uint8_t*>(deque_[i]);
+        DeallocateBlock(deque_[i]);
+    }
+
+    DeallocateMap(deque_, number_of_blocks_);
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::CopyArray(const Deque& other) {
+    deque_ = AllocateMap(other.number_of_blocks_);
+
+    for (size_t i = other.first_element_index_; i < other.first_element_index_ + other.deque_size_; ++i) {
+        AllocateBlock(i / size_of_array_);
+        alloc_traits::construct(allocator_, deque_[i / size_of_array_] + i % size_of_array_,
+                                other.deque_[i / size_of_array_][i % size_of_array_]);
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+void Deque<T, Allocator, BlockSize>::Reset() {
+    deque_ = nullptr;
+    first_element_index_ = 0;
+    number_of_blocks_ = 0;
+    deque_size_ = 0;
+    cache_ = nullptr;
+    cached_blocks_ = 0;
+}
+
+template <typename T, typename Allocator, size_t BlockSize, typename Function>
+Function for_each(Deque<T, Allocator, BlockSize>& deque, Function function) {
+    for (size_t i = 0; i < deque.segment_count(); ++i) {
+        typename Deque<T, Allocator, BlockSize>::segment segment = deque.get_segment(i);
+        for (T* element = segment.begin(); element != segment.end(); ++element) {
+            function(*element);
+        }
+    }
+
+    return function;
+}
+
+template <typename T, typename Allocator, size_t BlockSize, typename Function>
+Function for_each(const Deque<T, Allocator, BlockSize>& deque, Function function) {
+    for (size_t i = 0; i < deque.segment_count(); ++i) {
+        typename Deque<T, Allocator, BlockSize>::const_segment segment = deque.get_segment(i);
+        for (const T* element = segment.begin(); element != segment.end(); ++element) {
+            function(*element);
+        }
+    }
+
+    return function;
+}
+
+template <typename T, typename Allocator, size_t BlockSize, typename OutputIterator>
+OutputIterator copy(const Deque<T, Allocator, BlockSize>& deque, OutputIterator output) {
+    for (size_t i = 0; i < deque.segment_count(); ++i) {
+        typename Deque<T, Allocator, BlockSize>::const_segment segment = deque.get_segment(i);
+        output = std::copy(segment.begin(), segment.end(), output);
+    }
+
+    return output;
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+void fill(Deque<T, Allocator, BlockSize>& deque, const T& value) {
+    for (size_t i = 0; i < deque.segment_count(); ++i) {
+        typename Deque<T, Allocator, BlockSize>::segment segment = deque.get_segment(i);
+        std::fill(segment.begin(), segment.end(), value);
+    }
+}
+
+template <typename T, typename Allocator, size_t BlockSize, typename Value>
+Value accumulate(const Deque<T, Allocator, BlockSize>& deque, Value value) {
+    for (size_t i = 0; i < deque.segment_count(); ++i) {
+        typename Deque<T, Allocator, BlockSize>::const_segment segment = deque.get_segment(i);
+        for (const T* element = segment.begin(); element != segment.end(); ++element) {
+            value = value + *element;
+        }
+    }
+
+    return value;
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::const_iterator find(const Deque<T, Allocator, BlockSize>& deque, const T& value) {
+    size_t position = 0;
+    for (size_t i = 0; i < deque.segment_count(); ++i) {
+        typename Deque<T, Allocator, BlockSize>::const_segment segment = deque.get_segment(i);
+        const T* element = std::find(segment.begin(), segment.end(), value);
+        if (element != segment.end()) {
+            return deque.begin() + (position + (element - segment.begin()));
+        }
+        position += segment.size();
+    }
+
+    return deque.end();
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+typename Deque<T, Allocator, BlockSize>::iterator find(Deque<T, Allocator, BlockSize>& deque, const T& value) {
+    typename Deque<T, Allocator, BlockSize>::const_iterator it = find(static_cast<const Deque<T, Allocator, BlockSize>&>(deque), value);
+    return deque.begin() + (it - deque.cbegin());
+}
+
+template <typename T, typename Allocator = std::allocator<T>, size_t BlockSize = getDequeBlockSize(sizeof(T))>
+class SpscDeque {
+private:
+    struct Block;
+
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using block_allocator = typename alloc_traits::template rebind_alloc<Block>;
+    using block_traits = std::allocator_traits<block_allocator>;
+
+public:
+    SpscDeque();
+    explicit SpscDeque(const Allocator& allocator);
+    SpscDeque(const SpscDeque& other) = delete;
+    SpscDeque& operator=(const SpscDeque& other) = delete;
+    ~SpscDeque();
+
+    void push_back(const T& value);
+    void push_back(T&& value);
+
+    template <typename... Args>
+    void emplace_back(Args&&... args);
+
+    bool try_pop_front(T& value);
+    bool empty() const;
+
+private:
+    static const size_t cache_line_size_ = 64;
+
+    Block* AllocateBlock(Block* next);
+    static T* GetElement(Block* block, size_t index);
+
+    alignas(cache_line_size_) std::atomic<Block*> head_block_;
+    alignas(cache_line_size_) std::atomic<Block*> tail_block_;
+    Allocator allocator_;
+};
+
+template <typename T, typename Allocator, size_t BlockSize>
+struct SpscDeque<T, Allocator, BlockSize>::Block {
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type elements[BlockSize];
+    std::atomic<Block*> next;
+    alignas(cache_line_size_) std::atomic<size_t> back;
+    alignas(cache_line_size_) size_t front;
+
+    explicit Block(Block* next): next(next), back(0), front(0) {}
+};
+
+template <typename T, typename Allocator, size_t BlockSize>
+SpscDeque<T, Allocator, BlockSize>::SpscDeque(): SpscDeque(Allocator()) {}
+
+template <typename T, typename Allocator, size_t BlockSize>
+SpscDeque<T, Allocator, BlockSize>::SpscDeque(const Allocator& allocator): allocator_(allocator) {
+    Block* block = AllocateBlock(nullptr);
+    block->next.store(block, std::memory_order_relaxed);
+    head_block_.store(block, std::memory_order_relaxed);
+    tail_block_.store(block, std::memory_order_relaxed);
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+SpscDeque<T, Allocator, BlockSize>::~SpscDeque() {
+    Block* first = head_block_.load(std::memory_order_relaxed);
+    Block* last = tail_block_.load(std::memory_order_relaxed);
+    for (Block* block = first; ; block = block->next.load(std::memory_order_relaxed)) {
+        size_t back = block->back.load(std::memory_order_relaxed);
+        for (size_t i = block->front; i < back; ++i) {
+            alloc_traits::destroy(allocator_, GetElement(block, i));
+        }
+        if (block == last) {
+            break;
+        }
+    }
+
+    block_allocator allocator(allocator_);
+    Block* block = first;
+    do {
+        Block* next = block->next.load(std::memory_order_relaxed);
+        block_traits::destroy(allocator, block);
+        block_traits::deallocate(allocator, block, 1);
+        block = next;
+    } while (block != first);
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+void SpscDeque<T, Allocator, BlockSize>::push_back(const T& value) {
+    emplace_back(value);
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+void SpscDeque<T, Allocator, BlockSize>::push_back(T&& value) {
+    emplace_back(std::move(value));
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+template <typename... Args>
+void SpscDeque<T, Allocator, BlockSize>::emplace_back(Args&&... args) {
+    Block* block = tail_block_.load(std::memory_order_relaxed);
+    size_t back = block->back.load(std::memory_order_relaxed);
+    if (back < BlockSize) {
+        alloc_traits::construct(allocator_, GetElement(block, back), std::forward<Args>(args)...);
+        block->back.store(back + 1, std::memory_order_release);
+        return;
+    }
+
+    Block* next = block->next.load(std::memory_order_relaxed);
+    if (next == head_block_.load(std::memory_order_acquire)) {
+        next = AllocateBlock(next);
+        block->next.store(next, std::memory_order_release);
+    } else {
+        next->front = 0;
+        next->back.store(0, std::memory_order_relaxed);
+    }
+
+    alloc_traits::construct(allocator_, GetElement(next, 0), std::forward<Args>(args)...);
+    next->back.store(1, std::memory_order_release);
+    tail_block_.store(next, std::memory_order_release);
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+bool SpscDeque<T, Allocator, BlockSize>::try_pop_front(T& value) {
+    Block* block = head_block_.load(std::memory_order_relaxed);
+    size_t back = block->back.load(std::memory_order_acquire);
+    if (block->front == back) {
+        if (back < BlockSize || block == tail_block_.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        block = block->next.load(std::memory_order_acquire);
+        head_block_.store(block, std::memory_order_release);
     }
 
-    delete[] deque_;
+    T* element = GetElement(block, block->front);
+    value = std::move(*element);
+    alloc_traits::destroy(allocator_, element);
+    ++block->front;
+
+    return true;
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+bool SpscDeque<T, Allocator, BlockSize>::empty() const {
+    Block* block = head_block_.load(std::memory_order_relaxed);
+    size_t back = block->back.load(std::memory_order_acquire);
+
+    return block->front == back && (back < BlockSize || block == tail_block_.load(std::memory_order_acquire));
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+typename SpscDeque<T, Allocator, BlockSize>::Block* SpscDeque<T, Allocator, BlockSize>::AllocateBlock(Block* next) {
+    block_allocator allocator(allocator_);
+    Block* block = block_traits::allocate(allocator, 1);
+    block_traits::construct(allocator, block, next);
+
+    return block;
+}
+
+template <typename T, typename Allocator, size_t BlockSize>
+T* SpscDeque<T, Allocator, BlockSize>::GetElement(Block* block, size_t index) {
+    return std::launder(reinterpret_cast<T*>(&block->elements[index]));
 }
 
 template <typename T>
-void Deque<T>::CopyArray(const Deque& other) {
-    deque_ = new T*[other.number_of_blocks_];
+class WorkStealingDeque {
+private:
+    struct Buffer;
 
-    for (size_t i = 0; i < other.number_of_blocks_; ++i) {
-        deque_[i] = reinterpret_cast<T*>(new uint8_t[size_of_array_ * sizeof(T)]);
+public:
+    static_assert(std::is_trivially_copyable<T>::value);
+
+    explicit WorkStealingDeque(size_t capacity = default_capacity_);
+    WorkStealingDeque(const WorkStealingDeque& other) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque& other) = delete;
+    ~WorkStealingDeque();
+
+    size_t size() const;
+    bool empty() const;
+
+    void push_back(const T& value);
+    bool try_pop_back(T& value);
+    bool try_steal(T& value);
+
+private:
+    static const size_t default_capacity_ = 64;
+    static const size_t cache_line_size_ = 64;
+
+    Buffer* IncreaseBuffer(Buffer* buffer, long long bottom, long long top);
+
+    alignas(cache_line_size_) std::atomic<long long> top_;
+    alignas(cache_line_size_) std::atomic<long long> bottom_;
+    std::atomic<Buffer*> buffer_;
+    std::vector<Buffer*> retired_buffers_;
+};
+
+template <typename T>
+struct WorkStealingDeque<T>::Buffer {
+    size_t capacity;
+    std::atomic<T>* cells;
+
+    explicit Buffer(size_t capacity): capacity(capacity), cells(new std::atomic<T>[capacity]) {}
+
+    ~Buffer() {
+        delete[] cells;
     }
 
-    for (size_t i = other.first_element_index_; i < other.first_element_index_ + other.deque_size_; ++i) {
-        new(deque_[i / size_of_array_] + i % size_of_array_) T(other.deque_[i / size_of_array_][i % size_of_array_]);
+    T get(long long index) const {
+        return cells[index & (capacity - 1)].load(std::memory_order_relaxed);
     }
+
+    void put(long long index, const T& value) {
+        cells[index & (capacity - 1)].store(value, std::memory_order_relaxed);
+    }
+};
+
+template <typename T>
+WorkStealingDeque<T>::WorkStealingDeque(size_t capacity): top_(0),
+                                                    bottom_(0) {
+    size_t buffer_capacity = 1;
+    while (buffer_capacity < capacity) {
+        buffer_capacity <<= 1;
+    }
+    buffer_.store(new Buffer(buffer_capacity), std::memory_order_relaxed);
+}
+
+template <typename T>
+WorkStealingDeque<T>::~WorkStealingDeque() {
+    delete buffer_.load(std::memory_order_relaxed);
+    for (Buffer* buffer : retired_buffers_) {
+        delete buffer;
+    }
+}
+
+template <typename T>
+size_t WorkStealingDeque<T>::size() const {
+    long long bottom = bottom_.load(std::memory_order_relaxed);
+    long long top = top_.load(std::memory_order_relaxed);
+
+    return bottom > top ? bottom - top : 0;
+}
+
+template <typename T>
+bool WorkStealingDeque<T>::empty() const {
+    return size() == 0;
+}
+
+template <typename T>
+void WorkStealingDeque<T>::push_back(const T& value) {
+    long long bottom = bottom_.load(std::memory_order_relaxed);
+    long long top = top_.load(std::memory_order_acquire);
+    Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+    if (bottom - top > static_cast<long long>(buffer->capacity) - 1) {
+        buffer = IncreaseBuffer(buffer, bottom, top);
+    }
+
+    buffer->put(bottom, value);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+}
+
+template <typename T>
+bool WorkStealingDeque<T>::try_pop_back(T& value) {
+    long long bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long long top = top_.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    T element = buffer->get(bottom);
+    if (top == bottom) {
+        bool is_taken = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+        if (!is_taken) {
+            return false;
+        }
+    }
+
+    value = element;
+    return true;
+}
+
+template <typename T>
+bool WorkStealingDeque<T>::try_steal(T& value) {
+    long long top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long long bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) {
+        return false;
+    }
+
+    Buffer* buffer = buffer_.load(std::memory_order_acquire);
+    T element = buffer->get(top);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return false;
+    }
+
+    value = element;
+    return true;
+}
+
+template <typename T>
+typename WorkStealingDeque<T>::Buffer* WorkStealingDeque<T>::IncreaseBuffer(Buffer* buffer, long long bottom, long long top) {
+    Buffer* new_buffer = new Buffer(2 * buffer->capacity);
+    for (long long i = top; i < bottom; ++i) {
+        new_buffer->put(i, buffer->get(i));
+    }
+
+    retired_buffers_.push_back(buffer);
+    buffer_.store(new_buffer, std::memory_order_release);
+
+    return new_buffer;
 }
@@ -1,5 +1,11 @@
+#pragma once
+
+#include <array>
+#include <cmath>
 #include <iostream>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
 #include <vector>
 #include <string>
 
@@ -222,6 +228,33 @@ public:
         return number_.size();
     }
 
+    bool IsZero() const {
+        for (size_t i = Length(); i > 0; --i) {
+            if (number_[i - 1] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t SizeEstimate() const {
+        static const size_t digit_storage_bits = 30;
+
+        size_t top = Length();
+        while (top > 0 && number_[top - 1] == 0) {
+            --top;
+        }
+        if (top == 0) {
+            return 0;
+        }
+
+        size_t size = (top - 1) * digit_storage_bits;
+        for (long long digit = number_[top - 1]; digit != 0; digit >>= 1) {
+            ++size;
+        }
+        return size;
+    }
+
     BigInteger Abs() const {
         BigInteger copy = *this;
         copy.is_negative_ = false;
@@ -580,6 +613,14 @@ public:
         return numerator_.IsNegative();
     }
 
+    bool IsZero() const {
+        return numerator_.IsZero();
+    }
+
+    size_t SizeEstimate() const {
+        return numerator_.SizeEstimate() + denominator_.SizeEstimate();
+    }
+
     void Reform() {
         BigInteger value = Gcd(numerator_, denominator_);
         numerator_ /= value;
@@ -694,99 +735,234 @@ std::ostream& operator<<(std::ostream& out, Rational& number) {
     return out;
 }
 
-template <size_t N, size_t K, bool is_smaller>
-struct isPrimeHelper {
-    static const bool value = N % K == 0 ? false : isPrimeHelper<N, K + 1, K * K <= N>::value;
-};
+constexpr size_t powerModulo(size_t number, size_t power_number, size_t modulo) {
+    size_t result = 1 % modulo;
+    while (power_number != 0) {
+        if (power_number & 1) {
+            result = static_cast<size_t>(static_cast<unsigned __int128>(result) * number % modulo);
+        }
+        number = static_cast<size_t>(static_cast<unsigned __int128>(number) * number % modulo);
+        power_number >>= 1;
+    }
+    return result;
+}
 
-template <size_t N, size_t K>
-struct isPrimeHelper<N, K, false> {
-    static const bool value = true;
-};
+constexpr bool isPrimeNumber(size_t number) {
+    const size_t bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+
+    if (number < 2) {
+        return false;
+    }
+    for (size_t base : bases) {
+        if (number % base == 0) {
+            return number == base;
+        }
+    }
+
+    size_t odd_part = number - 1;
+    size_t two_power = 0;
+    while (odd_part % 2 == 0) {
+        odd_part /= 2;
+        ++two_power;
+    }
+
+    for (size_t base : bases) {
+        size_t witness = powerModulo(base, odd_part, number);
+        if (witness == 1 || witness == number - 1) {
+            continue;
+        }
+
+        bool is_composite = true;
+        for (size_t i = 1; i < two_power && is_composite; ++i) {
+            witness = static_cast<size_t>(static_cast<unsigned __int128>(witness) * witness % number);
+            is_composite = witness != number - 1;
+        }
+        if (is_composite) {
+            return false;
+        }
+    }
+    return true;
+}
 
 template <size_t N>
 struct isPrime {
-    static const bool value = isPrimeHelper<N, 2, N >= 4>::value;
-};
-
-template <>
-struct isPrime<1> {
-    static const bool value = false;
+    static const bool value = isPrimeNumber(N);
 };
 
 template <size_t N>
 const bool is_prime_v = isPrime<N>::value;
 
-template <size_t N>
-class Residue {
+constexpr size_t getMontgomeryInverse(size_t modulo) {
+    size_t inverse = modulo;
+    for (size_t i = 0; i < 6; ++i) {
+        inverse *= 2 - modulo * inverse;
+    }
+    return inverse;
+}
+
+constexpr size_t getMontgomerySquare(size_t modulo) {
+    unsigned __int128 remainder = static_cast<unsigned __int128>(-1) % modulo + 1;
+    return remainder % modulo;
+}
+
+class ModuloContext {
 public:
-    Residue() = default;
+    constexpr explicit ModuloContext(size_t modulo): modulo_(modulo),
+                                                     is_small_modulo_(modulo <= (static_cast<size_t>(1) << 32)),
+                                                     is_montgomery_modulo_(!is_small_modulo_ && modulo % 2 == 1),
+                                                     barrett_reciprocal_(static_cast<size_t>(-1) / modulo),
+                                                     montgomery_inverse_(getMontgomeryInverse(modulo)),
+                                                     montgomery_square_(is_montgomery_modulo_ ? getMontgomerySquare(modulo) : 0) {}
 
-    Residue(int value) {
+    constexpr size_t getModulo() const {
+        return modulo_;
+    }
+
+    constexpr size_t reduce(long long value) const {
         if (value < 0) {
-            value *= 1 - N;
+            size_t remainder = static_cast<size_t>(-(value + 1)) % modulo_;
+            return modulo_ - 1 - remainder;
+        }
+        return static_cast<size_t>(value) % modulo_;
+    }
+
+    constexpr size_t add(size_t lhs, size_t rhs) const {
+        return lhs >= modulo_ - rhs ? lhs - (modulo_ - rhs) : lhs + rhs;
+    }
+
+    constexpr size_t subtract(size_t lhs, size_t rhs) const {
+        return lhs >= rhs ? lhs - rhs : modulo_ - (rhs - lhs);
+    }
+
+    constexpr size_t multiply(size_t lhs, size_t rhs) const {
+        if (is_small_modulo_) {
+            size_t product = lhs * rhs;
+            size_t quotient = static_cast<size_t>((static_cast<unsigned __int128>(product) * barrett_reciprocal_) >> 64);
+            size_t remainder = product - quotient * modulo_;
+            while (remainder >= modulo_) {
+                remainder -= modulo_;
+            }
+            return remainder;
+        }
+        if (is_montgomery_modulo_) {
+            size_t reduced = reduceMontgomery(static_cast<unsigned __int128>(lhs) * rhs);
+            return reduceMontgomery(static_cast<unsigned __int128>(reduced) * montgomery_square_);
+        }
+        return static_cast<size_t>((static_cast<unsigned __int128>(lhs) * rhs) % modulo_);
+    }
+
+    constexpr size_t power(size_t number, size_t power_number) const {
+        size_t result = 1 % modulo_;
+        while (power_number != 0) {
+            if (power_number & 1) {
+                result = multiply(result, number);
+            }
+            number = multiply(number, number);
+            power_number >>= 1;
+        }
+        return result;
+    }
+
+    constexpr size_t invert(size_t number) const {
+        size_t remainder = modulo_;
+        size_t new_remainder = number;
+        __int128 koef = 0;
+        __int128 new_koef = 1;
+        while (new_remainder != 0) {
+            size_t quotient = remainder / new_remainder;
+
+            size_t next_remainder = remainder - quotient * new_remainder;
+            remainder = new_remainder;
+            new_remainder = next_remainder;
+
+            __int128 next_koef = koef - static_cast<__int128>(quotient) * new_koef;
+            koef = new_koef;
+            new_koef = next_koef;
         }
 
-        value_ = value % N;
+        return koef < 0 ? static_cast<size_t>(koef + modulo_) : static_cast<size_t>(koef);
     }
 
+private:
+    constexpr size_t reduceMontgomery(unsigned __int128 number) const {
+        size_t low = static_cast<size_t>(number);
+        size_t high = static_cast<size_t>(number >> 64);
+        size_t correction = static_cast<size_t>((static_cast<unsigned __int128>(low * montgomery_inverse_) * modulo_) >> 64);
+        return high >= correction ? high - correction : modulo_ - (correction - high);
+    }
+
+    size_t modulo_;
+    bool is_small_modulo_;
+    bool is_montgomery_modulo_;
+    size_t barrett_reciprocal_;
+    size_t montgomery_inverse_;
+    size_t montgomery_square_;
+};
+
+template <size_t N>
+class Residue {
+public:
+    Residue() = default;
+
+    constexpr Residue(int value): value_(context_.reduce(value)) {}
+
     ~Residue() = default;
 
-    Residue(const Residue& other): value_(other.value_) {}
+    constexpr Residue(const Residue& other): value_(other.value_) {}
 
-    Residue& operator=(const Residue& other) {
+    constexpr Residue& operator=(const Residue& other) {
         value_ = other.value_;
         return *this;
     }
 
-    Residue& operator+=(const Residue& rhs) {
-        value_ = (value_ + rhs.value_) % N;
+    constexpr Residue& operator+=(const Residue& rhs) {
+        value_ = context_.add(value_, rhs.value_);
 
         return *this;
     }
 
-    Residue& operator-=(const Residue& rhs) {
-        value_ = value_ >= rhs.value_ ? value_ - rhs.value_ : N + value_ - rhs.value_;
+    constexpr Residue& operator-=(const Residue& rhs) {
+        value_ = context_.subtract(value_, rhs.value_);
 
         return *this;
     }
 
-    Residue& operator*=(const Residue& rhs) {
-        value_ = (value_ * rhs.value_) % N;
+    constexpr Residue& operator*=(const Residue& rhs) {
+        value_ = context_.multiply(value_, rhs.value_);
 
         return *this;
     }
 
-    Residue& operator/=(const Residue& rhs) {
+    constexpr Residue& operator/=(const Residue& rhs) {
         static_assert(is_prime_v<N>);
 
-        value_ = (value_ * rhs.invert()) % N;
+        value_ = context_.multiply(value_, context_.invert(rhs.value_));
 
         return *this;
     }
 
-    Residue operator+(const Residue& rhs) const {
+    constexpr Residue operator+(const Residue& rhs) const {
         Residue copy = *this;
         copy += rhs;
 
         return copy;
     }
 
-    Residue operator-(const Residue& rhs) const {
+    constexpr Residue operator-(const Residue& rhs) const {
         Residue copy = *this;
         copy -= rhs;
 
         return copy;
     }
 
-    Residue operator*(const Residue& rhs) const {
+    constexpr Residue operator*(const Residue& rhs) const {
         Residue copy = *this;
         copy *= rhs;
 
         return copy;
     }
 
-    Residue operator/(const Residue& rhs) const {
+    constexpr Residue operator/(const Residue& rhs) const {
         static_assert(is_prime_v<N>);
 
         Residue copy = *this;
@@ -795,60 +971,56 @@ public:
         return copy;
     }
 
-    explicit operator int() const {
+    constexpr explicit operator int() const {
         return value_;
     }
 
-    bool operator<(const Residue& rhs) const {
+    constexpr bool operator<(const Residue& rhs) const {
         return value_ < rhs.value_;
     }
 
-    bool operator>(const Residue& rhs) const {
+    constexpr bool operator>(const Residue& rhs) const {
         return rhs < *this;
     }
 
-    bool operator==(const Residue& rhs) const {
+    constexpr bool operator==(const Residue& rhs) const {
         return value_ == rhs.value_;
     }
 
-    bool operator<=(const Residue& rhs) const {
+    constexpr bool operator<=(const Residue& rhs) const {
         return *this < rhs || *this == rhs;
     }
 
-    bool operator>=(const Residue& rhs) const {
+    constexpr bool operator>=(const Residue& rhs) const {
         return *this > rhs || *this == rhs;
     }
 
-    bool operator!=(const Residue& rhs) const {
+    constexpr bool operator!=(const Residue& rhs) const {
         return *this < rhs || *this > rhs;
     }
 
-    size_t getValue() const {
+    constexpr size_t getValue() const {
         return value_;
     }
 
-private:
-    size_t power(size_t number, size_t power_number) const {
-        if (power_number == 1) {
-            return number;
-        }
-
-        size_t helper;
-        if (power_number % 2 == 0) {
-            helper = power(number, power_number / 2);
-            return (helper * helper) % N;
-        } else {
+    constexpr Residue inverted() const {
+        Residue result;
+        result.value_ = context_.invert(value_);
 
-            helper = power(number, power_number - 1);
-            return helper * number;
-        }
+        return result;
     }
 
-    size_t invert() const {
-        return power(value_, N - 2);
+    constexpr Residue pow(size_t exponent) const {
+        Residue result;
+        result.value_ = context_.power(value_, exponent);
+
+        return result;
     }
 
-    size_t value_;
+private:
+    static constexpr ModuloContext context_ = ModuloContext(N);
+
+    size_t value_ = 0;
 };
 
 template <size_t N>
@@ -858,233 +1030,756 @@ std::ostream& operator<<(std::ostream& out, const Residue<N>& number) {
     return out;
 }
 
-template <size_t M, size_t N, typename Field = Rational>
-class Matrix {
+class RuntimeResidue {
 public:
-    Matrix() {
-            for (size_t j = 0; j < N; ++j) {
-                matrix_[i][j] = 0;
-            }
-        }
-    }
-
-    Matrix(std::vector<std::vector<Field>> matrix): matrix_(matrix) {}
-
-    Matrix(std::initializer_list<std::vector<Field>> matrix): matrix_(matrix) {}
+    RuntimeResidue(): value_(0), context_(nullptr) {}
 
-    ~Matrix() = default;
+    RuntimeResidue(int value): value_(static_cast<size_t>(static_cast<long long>(value))), context_(nullptr) {}
 
-    Matrix(const Matrix& other): matrix_(other.matrix_) {}
+    RuntimeResidue(long long value, const ModuloContext& context): value_(context.reduce(value)), context_(&context) {}
 
-    Matrix& operator=(const Matrix& other) {
-        matrix_ = other.matrix_;
+    RuntimeResidue& operator+=(const RuntimeResidue& rhs) {
+        RuntimeResidue other = rhs;
+        if (!unify(other)) {
+            value_ = static_cast<size_t>(getSigned() + other.getSigned());
+            return *this;
+        }
+        value_ = context_->add(value_, other.value_);
 
         return *this;
     }
 
-    std::vector<Field>& operator[](size_t position) {
-        return matrix_[position];
-    }
+    RuntimeResidue& operator-=(const RuntimeResidue& rhs) {
+        RuntimeResidue other = rhs;
+        if (!unify(other)) {
+            value_ = static_cast<size_t>(getSigned() - other.getSigned());
+            return *this;
+        }
+        value_ = context_->subtract(value_, other.value_);
 
-    const std::vector<Field> operator[](size_t position) const {
-        return matrix_[position];
+        return *this;
     }
 
-    template <size_t K, size_t T>
-    Matrix& operator+=(const Matrix<K, T, Field>& rhs) {
-        static_assert(M == K && N == T);
-
-        for (size_t i = 0; i < M; ++i) {
-            for (size_t j = 0; j < N; ++j) {
-                matrix_[i][j] += rhs[i][j];
-            }
+    RuntimeResidue& operator*=(const RuntimeResidue& rhs) {
+        RuntimeResidue other = rhs;
+        if (!unify(other)) {
+            value_ = static_cast<size_t>(getSigned() * other.getSigned());
+            return *this;
         }
+        value_ = context_->multiply(value_, other.value_);
 
         return *this;
     }
-        matrix_.resize(M);
-        for (size_t i = 0; i < M; ++i) {
-            matrix_[i].resize(N);
-
-    template <size_t K, size_t T>
-    Matrix& operator-=(const Matrix<K, T, Field>& rhs) {
-        static_assert(M == K && N == T);
 
-        for (size_t i = 0; i < M; ++i) {
-            for (size_t j = 0; j < N; ++j) {
-                matrix_[i][j] -= rhs[i][j];
-            }
+    RuntimeResidue& operator/=(const RuntimeResidue& rhs) {
+        RuntimeResidue other = rhs;
+        if (!unify(other)) {
+            throw std::logic_error("RESIDUE WITHOUT MODULO");
         }
+        value_ = context_->multiply(value_, context_->invert(other.value_));
 
         return *this;
     }
 
-    template <size_t K, size_t T>
-    Matrix operator+(const Matrix<K, T, Field>& rhs) const {
-        static_assert(M == K && N == T);
-
-        Matrix copy = *this;
+    RuntimeResidue operator+(const RuntimeResidue& rhs) const {
+        RuntimeResidue copy = *this;
         copy += rhs;
 
         return copy;
     }
 
-    template <size_t K, size_t T>
-    Matrix operator-(const Matrix<K, T, Field>& rhs) const {
-        static_assert(M == K && N == T);
-
-        Matrix copy = *this;
+    RuntimeResidue operator-(const RuntimeResidue& rhs) const {
+        RuntimeResidue copy = *this;
         copy -= rhs;
 
         return copy;
     }
 
-    Matrix& operator*=(const Field& number) {
-        for (size_t i = 0; i < M; ++i) {
-            for (size_t j = 0; j < N; ++j) {
-                matrix_[i][j] *= number;
-            }
-        }
+    RuntimeResidue operator*(const RuntimeResidue& rhs) const {
+        RuntimeResidue copy = *this;
+        copy *= rhs;
 
-        return *this;
+        return copy;
     }
 
-    Matrix operator*(const Field& number) const {
-        Matrix copy = *this;
-        copy *= number;
+    RuntimeResidue operator/(const RuntimeResidue& rhs) const {
+        RuntimeResidue copy = *this;
+        copy /= rhs;
 
         return copy;
     }
 
-    template <size_t K, size_t T>
-    Matrix<M, T, Field> operator*(const Matrix<K, T, Field>& rhs) const {
-        static_assert(N == K);
-
-        std::vector<std::vector<Field>> new_matrix(M);
-        for (size_t i = 0; i < M; ++i) {
-            new_matrix[i].resize(T);
-            for (size_t z = 0; z < T; ++z) {
-                Field sum = 0;
-                for (size_t j = 0; j < N; ++j) {
-                    sum += matrix_[i][j] * rhs[j][z];
-                }
-                new_matrix[i][z] = sum;
-            }
-        }
+    bool operator==(const RuntimeResidue& rhs) const {
+        RuntimeResidue lhs = *this;
+        RuntimeResidue other = rhs;
+        lhs.unify(other);
 
-        return Matrix<M, T, Field>(new_matrix);
+        return lhs.value_ == other.value_;
     }
 
-    template <size_t K>
-    Matrix& operator*=(const Matrix<K, K, Field>& rhs) {
-        static_assert(N == M && M == K);
+    bool operator!=(const RuntimeResidue& rhs) const {
+        return !(*this == rhs);
+    }
 
-        Matrix<M, M, Field> copy = *this * rhs;
-        *this = copy;
+    size_t getValue() const {
+        return value_;
+    }
 
-        return *this;
+    const ModuloContext* getContext() const {
+        return context_;
     }
 
-    bool operator==(const Matrix& rhs) const {
-        for (size_t i = 0; i < M; ++i) {
-            for (size_t j = 0; j < N; ++j) {
-                if (matrix_[i][j] != rhs[i][j]) {
-                    return false;
-                }
-            }
+    RuntimeResidue inverted() const {
+        if (context_ == nullptr) {
+            throw std::logic_error("RESIDUE WITHOUT MODULO");
         }
-        return true;
-    }
 
-    bool operator!=(const Matrix& rhs) const {
-        return !(*this == rhs);
+        RuntimeResidue result = *this;
+        result.value_ = context_->invert(value_);
+
+        return result;
     }
 
-    Field det() const {
-        static_assert(M == N);
+    RuntimeResidue pow(size_t exponent) const {
+        if (context_ == nullptr) {
+            throw std::logic_error("RESIDUE WITHOUT MODULO");
+        }
 
-        Matrix copy = *this;
-        size_t time_of_changes = getUpperTriangular(copy);
+        RuntimeResidue result = *this;
+        result.value_ = context_->power(value_, exponent);
 
-        Field determinant = 1;
-        for (size_t i = 0; i < M; ++i) {
-            determinant *= copy[i][i];
-        }
+        return result;
+    }
 
-        return time_of_changes % 2 ? determinant * (-1) : determinant;
+private:
+    long long getSigned() const {
+        return static_cast<long long>(value_);
     }
 
-    Matrix<N, M, Field> transposed() const {
-        std::vector<std::vector<Field>> matrix(N);
-        for (size_t i = 0; i < N; ++i) {
-            matrix[i].resize(M);
-            for (size_t j = 0; j < M; ++j) {
-                matrix[i][j] = matrix_[j][i];
-            }
-        }
+    void bind(const ModuloContext* context) {
+        value_ = context->reduce(getSigned());
+        context_ = context;
+    }
 
-        return Matrix<N, M, Field>(matrix);
+    bool unify(RuntimeResidue& other) {
+        if (context_ == other.context_) {
+            return context_ != nullptr;
+        }
+        if (context_ == nullptr) {
+            bind(other.context_);
+        } else if (other.context_ == nullptr) {
+            other.bind(context_);
+        } else if (context_->getModulo() != other.context_->getModulo()) {
+            throw std::invalid_argument("MODULO MISMATCH");
+        }
+        return true;
     }
 
-    size_t rank() const {
-        Matrix copy = *this;
-        getSteppedMatrix(copy);
+    size_t value_;
+    const ModuloContext* context_;
+};
 
-        size_t answer = 0;
-        for (size_t i = 0 ; i < M; ++i) {
-            if (!copy.isZero(i)) {
-                ++answer;
-            }
-        }
+std::ostream& operator<<(std::ostream& out, const RuntimeResidue& number) {
+    out << number.getValue();
 
-        return answer;
+    return out;
+}
+
+template <size_t N>
+void invertAll(std::vector<Residue<N>>& numbers) {
+    if (numbers.empty()) {
+        return;
     }
 
-    Matrix& invert() {
-        static_assert(M == N);
+    std::vector<Residue<N>> prefix(numbers.size());
+    prefix[0] = numbers[0];
+    for (size_t i = 1; i < numbers.size(); ++i) {
+        prefix[i] = prefix[i - 1] * numbers[i];
+    }
 
-        Matrix<M, 2 * N, Field> copy;
-        getChangedUnityMatrix(copy);
+    Residue<N> inverse = prefix.back().inverted();
+    for (size_t i = numbers.size() - 1; i > 0; --i) {
+        Residue<N> current = inverse * prefix[i - 1];
+        inverse *= numbers[i];
+        numbers[i] = current;
+    }
+    numbers[0] = inverse;
+}
 
-        for (size_t i = 0; i < M; ++i) {
-            for (size_t j = 0; j < N; ++j) {
-                matrix_[i][j] = copy[i][j + N];
+constexpr size_t getPrimitiveRoot(size_t modulo) {
+    size_t factors[64] = {};
+    size_t number_of_factors = 0;
+    size_t rest = modulo - 1;
+    for (size_t divisor = 2; divisor * divisor <= rest; ++divisor) {
+        if (rest % divisor == 0) {
+            factors[number_of_factors++] = divisor;
+            while (rest % divisor == 0) {
+                rest /= divisor;
             }
         }
-
-        return *this;
+    }
+    if (rest > 1) {
+        factors[number_of_factors++] = rest;
     }
 
-    Matrix inverted() const {
-        static_assert(M == N);
-
-        Matrix copy = *this;
+    for (size_t root = 2; root < modulo; ++root) {
+        bool is_generator = true;
+        for (size_t i = 0; i < number_of_factors && is_generator; ++i) {
+            is_generator = powerModulo(root, (modulo - 1) / factors[i], modulo) != 1;
+        }
+        if (is_generator) {
+            return root;
+        }
+    }
+    return 1;
+}
 
-        return copy.invert();
+constexpr size_t getTwoAdicity(size_t number) {
+    size_t adicity = 0;
+    while (number != 0 && number % 2 == 0) {
+        number /= 2;
+        ++adicity;
     }
+    return adicity;
+}
 
-    Field trace() const {
-        static_assert(M == N);
+template <size_t N, size_t K>
+struct FactorialTable {
+    static_assert(is_prime_v<N>);
+    static_assert(K > 0 && K < N);
 
-        Field sum = 0;
+    constexpr FactorialTable() {
+        factorials[0] = 1;
+        for (size_t i = 1; i < K; ++i) {
+            factorials[i] = factorials[i - 1] * Residue<N>(static_cast<int>(i));
+        }
 
-        for (size_t i = 0; i < N; ++i) {
-            sum += matrix_[i][i];
+        inverse_factorials[K - 1] = factorials[K - 1].pow(N - 2);
+        for (size_t i = K - 1; i > 0; --i) {
+            inverse_factorials[i - 1] = inverse_factorials[i] * Residue<N>(static_cast<int>(i));
         }
+    }
 
-        return sum;
+    constexpr Residue<N> binomial(size_t n, size_t k) const {
+        if (k > n) {
+            return 0;
+        }
+        return factorials[n] * inverse_factorials[k] * inverse_factorials[n - k];
     }
 
-    std::vector<Field> getRow(size_t row) const {
-        return matrix_[row];
+    constexpr Residue<N> inverse(size_t n) const {
+        if (n == 0) {
+            throw std::invalid_argument("DIVISION BY ZERO");
+        }
+        return inverse_factorials[n] * factorials[n - 1];
     }
 
-    std::vector<Field> getColumn(size_t column) const {
-        std::vector<Field> matrix_column;
-        for (size_t i = 0; i < M; ++i) {
-            matrix_column.push_back(matrix_[i][column]);
+    std::array<Residue<N>, K> factorials;
+    std::array<Residue<N>, K> inverse_factorials;
+};
+
+template <size_t N>
+struct RootTable {
+    static_assert(is_prime_v<N>);
+
+    static const size_t max_log = getTwoAdicity(N - 1);
+    static const size_t primitive_root = getPrimitiveRoot(N);
+
+    constexpr RootTable() {
+        roots[max_log] = Residue<N>(static_cast<int>(primitive_root)).pow((N - 1) >> max_log);
+        inverse_roots[max_log] = roots[max_log].pow(N - 2);
+        for (size_t i = max_log; i > 0; --i) {
+            roots[i - 1] = roots[i] * roots[i];
+            inverse_roots[i - 1] = inverse_roots[i] * inverse_roots[i];
         }
-        return matrix_column;
+    }
+
+    std::array<Residue<N>, max_log + 1> roots;
+    std::array<Residue<N>, max_log + 1> inverse_roots;
+};
+
+template <size_t N, size_t K>
+constexpr FactorialTable<N, K> factorial_table = FactorialTable<N, K>();
+
+template <size_t N>
+constexpr RootTable<N> root_table = RootTable<N>();
+
+std::vector<bool> getBinaryDigits(size_t number) {
+    std::vector<bool> digits;
+    while (number != 0) {
+        digits.push_back(number & 1);
+        number >>= 1;
+    }
+    return digits;
+}
+
+std::vector<bool> getBinaryDigits(const BigInteger& number) {
+    static const long long digit_size = 1000000000;
+
+    std::vector<long long> limbs(number.Length());
+    for (size_t i = 0; i < limbs.size(); ++i) {
+        limbs[i] = number[i];
+    }
+
+    std::vector<bool> digits;
+    while (!limbs.empty()) {
+        digits.push_back(limbs[0] & 1);
+        long long carry = 0;
+        for (size_t i = limbs.size(); i > 0; --i) {
+            long long current = limbs[i - 1] + carry * digit_size;
+            limbs[i - 1] = current >> 1;
+            carry = current & 1;
+        }
+        while (!limbs.empty() && limbs.back() == 0) {
+            limbs.pop_back();
+        }
+    }
+    return digits;
+}
+
+template <typename Field>
+class LinearRecurrence {
+public:
+    LinearRecurrence(const std::vector<Field>& coefficients, const std::vector<Field>& initial_values): coefficients_(coefficients),
+                                                                                                     initial_values_(initial_values),
+                                                                                                     product_(2 * coefficients.size()) {
+        if (coefficients_.size() != initial_values_.size()) {
+            throw std::invalid_argument("ORDER MISMATCH");
+        }
+    }
+
+    Field getTerm(size_t index) {
+        return getTermByDigits(getBinaryDigits(index));
+    }
+
+    Field getTerm(const BigInteger& index) {
+        if (index.IsNegative()) {
+            throw std::invalid_argument("NEGATIVE INDEX");
+        }
+
+        return getTermByDigits(getBinaryDigits(index));
+    }
+
+private:
+    Field getTermByDigits(const std::vector<bool>& digits) {
+        size_t order = coefficients_.size();
+        if (order == 0) {
+            return 0;
+        }
+
+        std::vector<Field> remainder(order, 0);
+        remainder[0] = 1;
+        for (size_t i = digits.size(); i > 0; --i) {
+            square(remainder);
+            if (digits[i - 1]) {
+                shift(remainder);
+            }
+        }
+
+        Field term = 0;
+        for (size_t i = 0; i < order; ++i) {
+            term += remainder[i] * initial_values_[i];
+        }
+        return term;
+    }
+
+    void square(std::vector<Field>& polynomial) {
+        size_t order = coefficients_.size();
+        for (size_t i = 0; i < 2 * order; ++i) {
+            product_[i] = 0;
+        }
+
+        for (size_t i = 0; i < order; ++i) {
+            if (polynomial[i] == 0) {
+                continue;
+            }
+            for (size_t j = 0; j < order; ++j) {
+                product_[i + j] += polynomial[i] * polynomial[j];
+            }
+        }
+
+        for (size_t degree = 2 * order - 1; degree >= order; --degree) {
+            if (product_[degree] == 0) {
+                continue;
+            }
+            for (size_t i = 0; i < order; ++i) {
+                product_[degree - 1 - i] += product_[degree] * coefficients_[i];
+            }
+        }
+
+        for (size_t i = 0; i < order; ++i) {
+            polynomial[i] = product_[i];
+        }
+    }
+
+    void shift(std::vector<Field>& polynomial) const {
+        size_t order = coefficients_.size();
+        Field highest = polynomial[order - 1];
+        for (size_t i = order - 1; i > 0; --i) {
+            polynomial[i] = polynomial[i - 1];
+        }
+        polynomial[0] = 0;
+
+        for (size_t i = 0; i < order; ++i) {
+            polynomial[order - 1 - i] += highest * coefficients_[i];
+        }
+    }
+
+    std::vector<Field> coefficients_;
+    std::vector<Field> initial_values_;
+    std::vector<Field> product_;
+};
+
+template <size_t M, size_t N, typename Field = Rational>
+class Matrix;
+
+template <size_t M, size_t N, typename Field, typename Expression>
+class MatrixScaled;
+
+template <size_t M, size_t N, typename Field>
+class MatrixTemporary;
+
+template <size_t M, size_t N, typename Field>
+class MatrixTransposedView;
+
+template <typename Field>
+bool isZeroElement(const Field& value) {
+    return value == 0;
+}
+
+bool isZeroElement(const Rational& value) {
+    return value.IsZero();
+}
+
+template <typename Field, typename Enable = void>
+struct PivotSelector {
+    static bool isBetter(const Field&, const Field&) {
+        return false;
+    }
+};
+
+template <>
+struct PivotSelector<Rational> {
+    static bool isBetter(const Rational& candidate, const Rational& current) {
+        return candidate.SizeEstimate() < current.SizeEstimate();
+    }
+};
+
+template <typename Field>
+struct PivotSelector<Field, typename std::enable_if<std::is_floating_point<Field>::value>::type> {
+    static bool isBetter(const Field& candidate, const Field& current) {
+        return std::abs(candidate) > std::abs(current);
+    }
+};
+
+template <typename Expression>
+struct ExpressionOperand {
+    using type = Expression;
+};
+
+template <size_t M, size_t N, typename Field>
+struct ExpressionOperand<Matrix<M, N, Field>> {
+    using type = MatrixTemporary<M, N, Field>;
+};
+
+template <size_t M, size_t N, typename Field, typename Expression>
+class MatrixExpression {
+public:
+    using temporary_type = typename ExpressionOperand<Expression>::type;
+
+    const Expression& getExpression() const & {
+        return static_cast<const Expression&>(*this);
+    }
+
+    Expression&& getExpression() && {
+        return static_cast<Expression&&>(*this);
+    }
+
+    friend MatrixScaled<M, N, Field, Expression> operator*(const MatrixExpression& lhs, const Field& rhs) {
+        return MatrixScaled<M, N, Field, Expression>(lhs.getExpression(), rhs);
+    }
+
+    friend MatrixScaled<M, N, Field, Expression> operator*(const Field& lhs, const MatrixExpression& rhs) {
+        return MatrixScaled<M, N, Field, Expression>(rhs.getExpression(), lhs);
+    }
+
+    friend MatrixScaled<M, N, Field, temporary_type> operator*(MatrixExpression&& lhs, const Field& rhs) {
+        return MatrixScaled<M, N, Field, temporary_type>(std::move(lhs).getExpression(), rhs);
+    }
+
+    friend MatrixScaled<M, N, Field, temporary_type> operator*(const Field& lhs, MatrixExpression&& rhs) {
+        return MatrixScaled<M, N, Field, temporary_type>(std::move(rhs).getExpression(), lhs);
+    }
+
+    Field det() const {
+        return Matrix<M, N, Field>(*this).det();
+    }
+
+    Matrix<N, M, Field> transposed() const {
+        return Matrix<M, N, Field>(*this).transposed();
+    }
+
+    size_t rank() const {
+        return Matrix<M, N, Field>(*this).rank();
+    }
+
+    Matrix<M, N, Field> inverted() const {
+        return Matrix<M, N, Field>(*this).inverted();
+    }
+
+    Field trace() const {
+        return Matrix<M, N, Field>(*this).trace();
+    }
+
+    Matrix<M, N, Field> pow(size_t exponent) const {
+        return Matrix<M, N, Field>(*this).pow(exponent);
+    }
+
+    Matrix<M, N, Field> pow(const BigInteger& exponent) const {
+        return Matrix<M, N, Field>(*this).pow(exponent);
+    }
+
+    std::vector<Field> getRow(size_t row) const {
+        return Matrix<M, N, Field>(*this).getRow(row);
+    }
+
+    std::vector<Field> getColumn(size_t column) const {
+        return Matrix<M, N, Field>(*this).getColumn(column);
+    }
+};
+
+template <size_t M, size_t N, typename Field>
+class Matrix: public MatrixExpression<M, N, Field, Matrix<M, N, Field>> {
+public:
+    static const bool is_elementwise = true;
+
+    Matrix() {
+        matrix_.resize(M);
+        for (size_t i = 0; i < M; ++i) {
+            matrix_[i].resize(N);
+            for (size_t j = 0; j < N; ++j) {
+                matrix_[i][j] = 0;
+            }
+        }
+    }
+
+    Matrix(std::vector<std::vector<Field>> matrix): matrix_(matrix) {}
+
+    Matrix(std::initializer_list<std::vector<Field>> matrix): matrix_(matrix) {}
+
+    ~Matrix() = default;
+
+    Matrix(const Matrix& other): matrix_(other.matrix_) {}
+
+    Matrix(Matrix&& other) noexcept = default;
+
+    Matrix& operator=(const Matrix& other) {
+        matrix_ = other.matrix_;
+
+        return *this;
+    }
+
+    Matrix& operator=(Matrix&& other) = default;
+
+    template <typename Expression>
+    Matrix(const MatrixExpression<M, N, Field, Expression>& other) {
+        const Expression& expression = other.getExpression();
+
+        matrix_.resize(M);
+        for (size_t i = 0; i < M; ++i) {
+            matrix_[i].reserve(N);
+            for (size_t j = 0; j < N; ++j) {
+                matrix_[i].push_back(expression.get(i, j));
+            }
+        }
+    }
+
+    template <typename Expression>
+    Matrix& operator=(const MatrixExpression<M, N, Field, Expression>& other) {
+        Matrix copy = other;
+        matrix_.swap(copy.matrix_);
+
+        return *this;
+    }
+
+    const Field& get(size_t row, size_t column) const {
+        return matrix_[row][column];
+    }
+
+    std::vector<Field>& operator[](size_t position) {
+        return matrix_[position];
+    }
+
+    const std::vector<Field> operator[](size_t position) const {
+        return matrix_[position];
+    }
+
+    template <typename Expression>
+    Matrix& operator+=(const MatrixExpression<M, N, Field, Expression>& rhs) {
+        if constexpr (!Expression::is_elementwise) {
+            return *this += Matrix(rhs);
+        }
+
+        const Expression& expression = rhs.getExpression();
+        for (size_t i = 0; i < M; ++i) {
+            for (size_t j = 0; j < N; ++j) {
+                matrix_[i][j] += expression.get(i, j);
+            }
+        }
+
+        return *this;
+    }
+
+    template <typename Expression>
+    Matrix& operator-=(const MatrixExpression<M, N, Field, Expression>& rhs) {
+        if constexpr (!Expression::is_elementwise) {
+            return *this -= Matrix(rhs);
+        }
+
+        const Expression& expression = rhs.getExpression();
+        for (size_t i = 0; i < M; ++i) {
+            for (size_t j = 0; j < N; ++j) {
+                matrix_[i][j] -= expression.get(i, j);
+            }
+        }
+
+        return *this;
+    }
+
+    Matrix& operator*=(const Field& number) {
+        for (size_t i = 0; i < M; ++i) {
+            for (size_t j = 0; j < N; ++j) {
+                matrix_[i][j] *= number;
+            }
+        }
+
+        return *this;
+    }
+
+    template <typename Expression>
+    Matrix& operator*=(const MatrixExpression<N, N, Field, Expression>& rhs) {
+        static_assert(N == M);
+
+        *this = *this * rhs;
+
+        return *this;
+    }
+
+    Matrix pow(size_t exponent) const {
+        static_assert(M == N);
+
+        return getPowerByDigits(getBinaryDigits(exponent));
+    }
+
+    Matrix pow(const BigInteger& exponent) const {
+        static_assert(M == N);
+
+        if (exponent.IsNegative()) {
+            return inverted().getPowerByDigits(getBinaryDigits(exponent));
+        }
+
+        return getPowerByDigits(getBinaryDigits(exponent));
+    }
+
+    Field det() const {
+        static_assert(M == N);
+
+        Matrix copy = *this;
+        size_t time_of_changes = getUpperTriangular(copy);
+
+        Field determinant = 1;
+        for (size_t i = 0; i < M; ++i) {
+            determinant *= copy[i][i];
+        }
+
+        return time_of_changes % 2 ? determinant * (-1) : determinant;
+    }
+
+    Matrix<N, M, Field> transposed() const {
+        std::vector<std::vector<Field>> matrix(N);
+        for (size_t i = 0; i < N; ++i) {
+            matrix[i].resize(M);
+        }
+        transposeBlock(matrix, 0, M, 0, N);
+
+        return Matrix<N, M, Field>(matrix);
+    }
+
+    Matrix& transpose() {
+        static_assert(M == N);
+
+        for (size_t i = 0; i < M; ++i) {
+            for (size_t j = i + 1; j < N; ++j) {
+                std::swap(matrix_[i][j], matrix_[j][i]);
+            }
+        }
+
+        return *this;
+    }
+
+    MatrixTransposedView<M, N, Field> transposedView() const {
+        return MatrixTransposedView<M, N, Field>(*this);
+    }
+
+    size_t rank() const {
+        Matrix copy = *this;
+        getSteppedMatrix(copy);
+
+        size_t answer = 0;
+        for (size_t i = 0 ; i < M; ++i) {
+            if (!copy.isZero(i)) {
+                ++answer;
+            }
+        }
+
+        return answer;
+    }
+
+    Matrix& invert() {
+        static_assert(M == N);
+
+        Matrix<M, 2 * N, Field> copy;
+        getChangedUnityMatrix(copy);
+
+        for (size_t i = 0; i < M; ++i) {
+            for (size_t j = 0; j < N; ++j) {
+                matrix_[i][j] = copy[i][j + N];
+            }
+        }
+
+        return *this;
+    }
+
+    Matrix inverted() const {
+        static_assert(M == N);
+
+        Matrix copy = *this;
+
+        return copy.invert();
+    }
+
+    Field trace() const {
+        static_assert(M == N);
+
+        Field sum = 0;
+
+        for (size_t i = 0; i < N; ++i) {
+            sum += matrix_[i][i];
+        }
+
+        return sum;
+    }
+
+    std::vector<Field> getRow(size_t row) const {
+        return matrix_[row];
+    }
+
+    std::vector<Field> getColumn(size_t column) const {
+        std::vector<Field> matrix_column;
+        for (size_t i = 0; i < M; ++i) {
+            matrix_column.push_back(matrix_[i][column]);
+        }
+        return matrix_column;
     }
 
     void print() const {
@@ -1097,6 +1792,63 @@ public:
     }
 
 private:
+    static const size_t transpose_block_size_ = 16;
+
+    void transposeBlock(std::vector<std::vector<Field>>& matrix, size_t row_begin, size_t row_end,
+                        size_t column_begin, size_t column_end) const {
+        size_t rows = row_end - row_begin;
+        size_t columns = column_end - column_begin;
+        if (rows <= transpose_block_size_ && columns <= transpose_block_size_) {
+            for (size_t i = row_begin; i < row_end; ++i) {
+                for (size_t j = column_begin; j < column_end; ++j) {
+                    matrix[j][i] = matrix_[i][j];
+                }
+            }
+            return;
+        }
+
+        if (rows >= columns) {
+            size_t middle = row_begin + rows / 2;
+            transposeBlock(matrix, row_begin, middle, column_begin, column_end);
+            transposeBlock(matrix, middle, row_end, column_begin, column_end);
+        } else {
+            size_t middle = column_begin + columns / 2;
+            transposeBlock(matrix, row_begin, row_end, column_begin, middle);
+            transposeBlock(matrix, row_begin, row_end, middle, column_end);
+        }
+    }
+
+    static void multiply(const Matrix& lhs, const Matrix& rhs, Matrix& result) {
+        for (size_t i = 0; i < M; ++i) {
+            for (size_t z = 0; z < N; ++z) {
+                Field& sum = result.matrix_[i][z];
+                sum = 0;
+                for (size_t j = 0; j < N; ++j) {
+                    sum += lhs.matrix_[i][j] * rhs.matrix_[j][z];
+                }
+            }
+        }
+    }
+
+    Matrix getPowerByDigits(const std::vector<bool>& digits) const {
+        Matrix result;
+        for (size_t i = 0; i < M; ++i) {
+            result.matrix_[i][i] = 1;
+        }
+
+        Matrix buffer;
+        for (size_t i = digits.size(); i > 0; --i) {
+            multiply(result, result, buffer);
+            result.matrix_.swap(buffer.matrix_);
+            if (digits[i - 1]) {
+                multiply(result, *this, buffer);
+                result.matrix_.swap(buffer.matrix_);
+            }
+        }
+
+        return result;
+    }
+
     template <size_t K, size_t T>
     void getChangedUnityMatrix(Matrix<K, T, Field>& matrix) const {
         for (size_t i = 0; i < K; ++i) {
@@ -1106,98 +1858,102 @@ private:
         }
 
         for (size_t i = 0; i < N; ++i) {
-            bool flag = false;
-            for (size_t j = i; j < M; ++j) {
-                if (matrix[j][i] != 0) {
-                    swapRow(matrix, i, j);
-                    flag = true;
-                    break;
-                }
+            size_t pivot = i;
+            if (findPivot(matrix, i, i, pivot)) {
+                swapRow(matrix, i, pivot);
+                Field pivot_inverse = Field(1) / matrix[i][i];
+                fullAnihilate(matrix, i, i, pivot_inverse);
+                reduceToOne(matrix, i, pivot_inverse);
             }
-            if (flag) {
-                fullAnihilate(matrix, i, i);
-            }
-            flag = false;
-            reduceToOne(matrix, i);
         }
     }
 
     void getSteppedMatrix(Matrix& matrix) const {
-        for (size_t i = 0; i < M; ++i) {
-            bool flag = false;
-            size_t position;
-            for (size_t j = 0; j < N; ++j) {
-                if (matrix[i][j] != 0) {
-                    flag = true;
-                    position = j;
-                    break;
-                }
-            }
-            if (flag) {
-                anihilate(matrix, i, position);
+        size_t row = 0;
+        for (size_t i = 0; i < N && row < M; ++i) {
+            size_t pivot = row;
+            if (findPivot(matrix, i, row, pivot)) {
+                swapRow(matrix, row, pivot);
+                anihilate(matrix, row, i);
+                ++row;
             }
-            flag = false;
         }
     }
 
     size_t getUpperTriangular(Matrix& matrix) const {
         size_t time_of_changes = 0;
         for (size_t i = 0; i < N; ++i) {
-            bool flag = false;
-            for (size_t j = i; j < M; ++j) {
-                if (matrix[j][i] != 0) {
-                    flag = true;
-                    swapRow(matrix, i, j);
-                    if (i != j) {
-                        ++time_of_changes;
-                    }
-                    break;
+            size_t pivot = i;
+            if (findPivot(matrix, i, i, pivot)) {
+                swapRow(matrix, i, pivot);
+                if (i != pivot) {
+                    ++time_of_changes;
                 }
-            }
-            if (flag) {
                 anihilate(matrix, i, i);
             }
-            flag = false;
         }
 
         return time_of_changes;
     }
 
+    template <size_t K, size_t T>
+    bool findPivot(const Matrix<K, T, Field>& matrix, size_t column, size_t first_row, size_t& pivot) const {
+        bool found = false;
+        for (size_t i = first_row; i < K; ++i) {
+            const Field& candidate = matrix.get(i, column);
+            if (isZeroElement(candidate)) {
+                continue;
+            }
+            if (!found || PivotSelector<Field>::isBetter(candidate, matrix.get(pivot, column))) {
+                pivot = i;
+                found = true;
+            }
+        }
+        return found;
+    }
+
     template <size_t K, size_t T>
     void swapRow(Matrix<K, T, Field>& matrix, size_t first, size_t second) const{
-        for (size_t i = 0; i < K; ++i) {
-            std::swap(matrix[first][i], matrix[second][i]);
+        if (first != second) {
+            matrix[first].swap(matrix[second]);
         }
     }
 
     template <size_t K, size_t T>
     void anihilate(Matrix<K, T, Field>& matrix, size_t row, size_t column) const {
+       const std::vector<Field>& pivot_row = matrix[row];
+       Field pivot_inverse = Field(1) / pivot_row[column];
        for (size_t i = row + 1; i < K; ++i) {
-           Field koef = matrix[i][column] / matrix[row][column];
-           for (size_t j = 0; j < T; ++j) {
-                matrix[i][j] -= matrix[row][j] * koef;
+           std::vector<Field>& current_row = matrix[i];
+           if (isZeroElement(current_row[column])) {
+               continue;
+           }
+           Field koef = current_row[column] * pivot_inverse;
+           for (size_t j = column; j < T; ++j) {
+                current_row[j] -= pivot_row[j] * koef;
            }
        }
     }
 
     template <size_t K, size_t T>
-    void fullAnihilate(Matrix<K, T, Field>& matrix, size_t row, size_t column) const {
+    void fullAnihilate(Matrix<K, T, Field>& matrix, size_t row, size_t column, const Field& pivot_inverse) const {
+        const std::vector<Field>& pivot_row = matrix[row];
         for (size_t i = 0; i < K; ++i) {
-            if (i == row) {
+            std::vector<Field>& current_row = matrix[i];
+            if (i == row || isZeroElement(current_row[column])) {
                 continue;
             }
-            Field koef = matrix[i][column] / matrix[row][column];
-            for (size_t j = 0; j < T; ++j) {
-                matrix[i][j] -= matrix[row][j] * koef;
+            Field koef = current_row[column] * pivot_inverse;
+            for (size_t j = column; j < T; ++j) {
+                current_row[j] -= pivot_row[j] * koef;
             }
         }
     }
 
     template <size_t K, size_t T>
-    void reduceToOne(Matrix<K, T, Field>& matrix, size_t row) const {
-        Field koef = Field(1) / matrix[row][row];
-        for (size_t i = 0; i < T; ++i) {
-            matrix[row][i] *= koef;
+    void reduceToOne(Matrix<K, T, Field>& matrix, size_t row, const Field& pivot_inverse) const {
+        for (size_t i = row; i < T; ++i) {
+            matrix[row][i] *= pivot_inverse;
         }
     }
 
@@ -1213,12 +1969,248 @@ private:
     std::vector<std::vector<Field>> matrix_;
 };
 
+template <typename Expression>
+struct ExpressionStorage {
+    using type = Expression;
+};
+
 template <size_t M, size_t N, typename Field>
-Matrix<M, N, Field> operator*(const Field& lhs, const Matrix<M, N, Field>& rhs) {
-    Matrix<M, N, Field> copy = rhs;
-    copy *= lhs;
+struct ExpressionStorage<Matrix<M, N, Field>> {
+    using type = const Matrix<M, N, Field>&;
+};
 
-    return copy;
+template <size_t M, size_t N, typename Field, typename Expression>
+struct ProductOperand {
+    using type = Matrix<M, N, Field>;
+};
+
+template <size_t M, size_t N, typename Field>
+struct ProductOperand<M, N, Field, Matrix<M, N, Field>> {
+    using type = const Matrix<M, N, Field>&;
+};
+
+template <size_t M, size_t N, typename Field>
+struct ProductOperand<M, N, Field, MatrixTransposedView<N, M, Field>> {
+    using type = MatrixTransposedView<N, M, Field>;
+};
+
+template <size_t M, size_t N, typename Field>
+class MatrixTemporary: public MatrixExpression<M, N, Field, MatrixTemporary<M, N, Field>> {
+public:
+    static const bool is_elementwise = true;
+
+    MatrixTemporary(Matrix<M, N, Field>&& matrix): matrix_(std::move(matrix)) {}
+
+    const Field& get(size_t row, size_t column) const {
+        return matrix_.get(row, column);
+    }
+
+private:
+    Matrix<M, N, Field> matrix_;
+};
+
+template <size_t M, size_t N, typename Field>
+struct ProductOperand<M, N, Field, MatrixTemporary<M, N, Field>> {
+    using type = MatrixTemporary<M, N, Field>;
+};
+
+template <size_t M, size_t N, typename Field>
+class MatrixTransposedView: public MatrixExpression<N, M, Field, MatrixTransposedView<M, N, Field>> {
+public:
+    static const bool is_elementwise = false;
+
+    explicit MatrixTransposedView(const Matrix<M, N, Field>& matrix): matrix_(matrix) {}
+
+    const Field& get(size_t row, size_t column) const {
+        return matrix_.get(column, row);
+    }
+
+private:
+    const Matrix<M, N, Field>& matrix_;
+};
+
+template <size_t M, size_t N, typename Field, typename Lhs, typename Rhs>
+class MatrixSum: public MatrixExpression<M, N, Field, MatrixSum<M, N, Field, Lhs, Rhs>> {
+public:
+    static const bool is_elementwise = Lhs::is_elementwise && Rhs::is_elementwise;
+
+    template <typename LhsOperand, typename RhsOperand>
+    MatrixSum(LhsOperand&& lhs, RhsOperand&& rhs): lhs_(std::forward<LhsOperand>(lhs)),
+                                                 rhs_(std::forward<RhsOperand>(rhs)) {}
+
+    Field get(size_t row, size_t column) const {
+        Field value = lhs_.get(row, column);
+        value += rhs_.get(row, column);
+
+        return value;
+    }
+
+private:
+    typename ExpressionStorage<Lhs>::type lhs_;
+    typename ExpressionStorage<Rhs>::type rhs_;
+};
+
+template <size_t M, size_t N, typename Field, typename Lhs, typename Rhs>
+class MatrixDifference: public MatrixExpression<M, N, Field, MatrixDifference<M, N, Field, Lhs, Rhs>> {
+public:
+    static const bool is_elementwise = Lhs::is_elementwise && Rhs::is_elementwise;
+
+    template <typename LhsOperand, typename RhsOperand>
+    MatrixDifference(LhsOperand&& lhs, RhsOperand&& rhs): lhs_(std::forward<LhsOperand>(lhs)),
+                                                 rhs_(std::forward<RhsOperand>(rhs)) {}
+
+    Field get(size_t row, size_t column) const {
+        Field value = lhs_.get(row, column);
+        value -= rhs_.get(row, column);
+
+        return value;
+    }
+
+private:
+    typename ExpressionStorage<Lhs>::type lhs_;
+    typename ExpressionStorage<Rhs>::type rhs_;
+};
+
+template <size_t M, size_t N, typename Field, typename Expression>
+class MatrixScaled: public MatrixExpression<M, N, Field, MatrixScaled<M, N, Field, Expression>> {
+public:
+    static const bool is_elementwise = Expression::is_elementwise;
+
+    template <typename Operand>
+    MatrixScaled(Operand&& expression, const Field& number): expression_(std::forward<Operand>(expression)),
+                                                             number_(number) {}
+
+    Field get(size_t row, size_t column) const {
+        Field value = expression_.get(row, column);
+        value *= number_;
+
+        return value;
+    }
+
+private:
+    typename ExpressionStorage<Expression>::type expression_;
+    Field number_;
+};
+
+template <size_t M, size_t K, size_t N, typename Field, typename Lhs, typename Rhs>
+class MatrixProduct: public MatrixExpression<M, N, Field, MatrixProduct<M, K, N, Field, Lhs, Rhs>> {
+public:
+    static const bool is_elementwise = false;
+
+    template <typename LhsOperand, typename RhsOperand>
+    MatrixProduct(LhsOperand&& lhs, RhsOperand&& rhs): lhs_(std::forward<LhsOperand>(lhs)),
+                                                 rhs_(std::forward<RhsOperand>(rhs)) {}
+
+    Field get(size_t row, size_t column) const {
+        Field sum = 0;
+        for (size_t j = 0; j < K; ++j) {
+            sum += lhs_.get(row, j) * rhs_.get(j, column);
+        }
+
+        return sum;
+    }
+
+private:
+    typename ProductOperand<M, K, Field, Lhs>::type lhs_;
+    typename ProductOperand<K, N, Field, Rhs>::type rhs_;
+};
+
+template <size_t M, size_t N, typename Field, typename Lhs, typename Rhs>
+MatrixSum<M, N, Field, Lhs, Rhs> operator+(const MatrixExpression<M, N, Field, Lhs>& lhs,
+        const MatrixExpression<M, N, Field, Rhs>& rhs) {
+    return MatrixSum<M, N, Field, Lhs, Rhs>(lhs.getExpression(), rhs.getExpression());
+}
+
+template <size_t M, size_t N, typename Field, typename Lhs, typename Rhs>
+MatrixSum<M, N, Field, typename ExpressionOperand<Lhs>::type, Rhs> operator+(
+        MatrixExpression<M, N, Field, Lhs>&& lhs, const MatrixExpression<M, N, Field, Rhs>& rhs) {
+    return MatrixSum<M, N, Field, typename ExpressionOperand<Lhs>::type, Rhs>(
+            std::move(lhs).getExpression(), rhs.getExpression());
+}
+
+template <size_t M, size_t N, typename Field, typename Lhs, typename Rhs>
+MatrixSum<M, N, Field, Lhs, typename ExpressionOperand<Rhs>::type> operator+(
+        const MatrixExpression<M, N, Field, Lhs>& lhs, MatrixExpression<M, N, Field, Rhs>&& rhs) {
+    return MatrixSum<M, N, Field, Lhs, typename ExpressionOperand<Rhs>::type>(
+            lhs.getExpression(), std::move(rhs).getExpression());
+}
+
+template <size_t M, size_t N, typename Field, typename Lhs, typename Rhs>
+MatrixSum<M, N, Field, typename ExpressionOperand<Lhs>::type, typename ExpressionOperand<Rhs>::type> operator+(
+        MatrixExpression<M, N, Field, Lhs>&& lhs, MatrixExpression<M, N, Field, Rhs>&& rhs) {
+    return MatrixSum<M, N, Field, typename ExpressionOperand<Lhs>::type, typename ExpressionOperand<Rhs>::type>(
+            std::move(lhs).getExpression(), std::move(rhs).getExpression());
+}
+
+template <size_t M, size_t N, typename Field, typename Lhs, typename Rhs>
+MatrixDifference<M, N, Field, Lhs, Rhs> operator-(const MatrixExpression<M, N, Field, Lhs>& lhs,
+        const MatrixExpression<M, N, Field, Rhs>& rhs) {
+    return MatrixDifference<M, N, Field, Lhs, Rhs>(lhs.getExpression(), rhs.getExpression());
+}
+
+template <size_t M, size_t N, typename Field, typename Lhs, typename Rhs>
+MatrixDifference<M, N, Field, typename ExpressionOperand<Lhs>::type, Rhs> operator-(
+        MatrixExpression<M, N, Field, Lhs>&& lhs, const MatrixExpression<M, N, Field, Rhs>& rhs) {
+    return MatrixDifference<M, N, Field, typename ExpressionOperand<Lhs>::type, Rhs>(
+            std::move(lhs).getExpression(), rhs.getExpression());
+}
+
+template <size_t M, size_t N, typename Field, typename Lhs, typename Rhs>
+MatrixDifference<M, N, Field, Lhs, typename ExpressionOperand<Rhs>::type> operator-(
+        const MatrixExpression<M, N, Field, Lhs>& lhs, MatrixExpression<M, N, Field, Rhs>&& rhs) {
+    return MatrixDifference<M, N, Field, Lhs, typename ExpressionOperand<Rhs>::type>(
+            lhs.getExpression(), std::move(rhs).getExpression());
+}
+
+template <size_t M, size_t N, typename Field, typename Lhs, typename Rhs>
+MatrixDifference<M, N, Field, typename ExpressionOperand<Lhs>::type, typename ExpressionOperand<Rhs>::type> operator-(
+        MatrixExpression<M, N, Field, Lhs>&& lhs, MatrixExpression<M, N, Field, Rhs>&& rhs) {
+    return MatrixDifference<M, N, Field, typename ExpressionOperand<Lhs>::type, typename ExpressionOperand<Rhs>::type>(
+            std::move(lhs).getExpression(), std::move(rhs).getExpression());
+}
+
+template <size_t M, size_t K, size_t N, typename Field, typename Lhs, typename Rhs>
+MatrixProduct<M, K, N, Field, Lhs, Rhs> operator*(const MatrixExpression<M, K, Field, Lhs>& lhs,
+                                                  const MatrixExpression<K, N, Field, Rhs>& rhs) {
+    return MatrixProduct<M, K, N, Field, Lhs, Rhs>(lhs.getExpression(), rhs.getExpression());
+}
+
+template <size_t M, size_t K, size_t N, typename Field, typename Lhs, typename Rhs>
+MatrixProduct<M, K, N, Field, typename ExpressionOperand<Lhs>::type, Rhs> operator*(
+        MatrixExpression<M, K, Field, Lhs>&& lhs, const MatrixExpression<K, N, Field, Rhs>& rhs) {
+    return MatrixProduct<M, K, N, Field, typename ExpressionOperand<Lhs>::type, Rhs>(
+            std::move(lhs).getExpression(), rhs.getExpression());
+}
+
+template <size_t M, size_t K, size_t N, typename Field, typename Lhs, typename Rhs>
+MatrixProduct<M, K, N, Field, Lhs, typename ExpressionOperand<Rhs>::type> operator*(
+        const MatrixExpression<M, K, Field, Lhs>& lhs, MatrixExpression<K, N, Field, Rhs>&& rhs) {
+    return MatrixProduct<M, K, N, Field, Lhs, typename ExpressionOperand<Rhs>::type>(
+            lhs.getExpression(), std::move(rhs).getExpression());
+}
+
+template <size_t M, size_t K, size_t N, typename Field, typename Lhs, typename Rhs>
+MatrixProduct<M, K, N, Field, typename ExpressionOperand<Lhs>::type, typename ExpressionOperand<Rhs>::type> operator*(
+        MatrixExpression<M, K, Field, Lhs>&& lhs, MatrixExpression<K, N, Field, Rhs>&& rhs) {
+    return MatrixProduct<M, K, N, Field, typename ExpressionOperand<Lhs>::type, typename ExpressionOperand<Rhs>::type>(
+            std::move(lhs).getExpression(), std::move(rhs).getExpression());
+}
+
+template <size_t M, size_t N, typename Field, typename Lhs, typename Rhs>
+bool operator==(const MatrixExpression<M, N, Field, Lhs>& lhs, const MatrixExpression<M, N, Field, Rhs>& rhs) {
+    for (size_t i = 0; i < M; ++i) {
+        for (size_t j = 0; j < N; ++j) {
+            if (lhs.getExpression().get(i, j) != rhs.getExpression().get(i, j)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <size_t M, size_t N, typename Field, typename Lhs, typename Rhs>
+bool operator!=(const MatrixExpression<M, N, Field, Lhs>& lhs, const MatrixExpression<M, N, Field, Rhs>& rhs) {
+    return !(lhs == rhs);
 }
 
 template <size_t N, typename Field = Rational>
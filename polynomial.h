@@ -0,0 +1,438 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#include "matrix.h"
+
+template <size_t N>
+class Polynomial {
+public:
+    static_assert(is_prime_v<N>);
+
+    Polynomial() = default;
+
+    Polynomial(const std::vector<Residue<N>>& coefficients): coefficients_(coefficients) {
+        Trim();
+    }
+
+    Polynomial(std::initializer_list<Residue<N>> coefficients): coefficients_(coefficients) {
+        Trim();
+    }
+
+    Polynomial(const Residue<N>& value): coefficients_(1, value) {
+        Trim();
+    }
+
+    size_t size() const {
+        return coefficients_.size();
+    }
+
+    Residue<N> operator[](size_t position) const {
+        return position < coefficients_.size() ? coefficients_[position] : Residue<N>(0);
+    }
+
+    const std::vector<Residue<N>>& getCoefficients() const {
+        return coefficients_;
+    }
+
+    Polynomial& operator+=(const Polynomial& rhs) {
+        if (coefficients_.size() < rhs.coefficients_.size()) {
+            coefficients_.resize(rhs.coefficients_.size(), 0);
+        }
+        for (size_t i = 0; i < rhs.coefficients_.size(); ++i) {
+            coefficients_[i] += rhs.coefficients_[i];
+        }
+        Trim();
+
+        return *this;
+    }
+
+    Polynomial& operator-=(const Polynomial& rhs) {
+        if (coefficients_.size() < rhs.coefficients_.size()) {
+            coefficients_.resize(rhs.coefficients_.size(), 0);
+        }
+        for (size_t i = 0; i < rhs.coefficients_.size(); ++i) {
+            coefficients_[i] -= rhs.coefficients_[i];
+        }
+        Trim();
+
+        return *this;
+    }
+
+    Polynomial& operator*=(const Polynomial& rhs) {
+        if (coefficients_.empty() || rhs.coefficients_.empty()) {
+            coefficients_.clear();
+            return *this;
+        }
+
+        if constexpr (has_transform_) {
+            size_t result_size = coefficients_.size() + rhs.coefficients_.size() - 1;
+            size_t transform_size = 1;
+            size_t level = 0;
+            while (transform_size < result_size) {
+                transform_size <<= 1;
+                ++level;
+            }
+
+            if (std::min(coefficients_.size(), rhs.coefficients_.size()) > naive_threshold_ &&
+                level <= max_transform_log_) {
+                std::vector<Residue<N>> rhs_values(rhs.coefficients_);
+                coefficients_.resize(transform_size, 0);
+                rhs_values.resize(transform_size, 0);
+                transform(coefficients_, false);
+                transform(rhs_values, false);
+                for (size_t i = 0; i < transform_size; ++i) {
+                    coefficients_[i] *= rhs_values[i];
+                }
+                transform(coefficients_, true);
+                coefficients_.resize(result_size);
+                Trim();
+
+                return *this;
+            }
+        }
+
+        multiplyNaive(rhs);
+
+        return *this;
+    }
+
+    Polynomial& operator/=(const Polynomial& rhs) {
+        *this = divide(rhs).first;
+
+        return *this;
+    }
+
+    Polynomial& operator%=(const Polynomial& rhs) {
+        *this = divide(rhs).second;
+
+        return *this;
+    }
+
+    Polynomial operator+(const Polynomial& rhs) const {
+        Polynomial copy = *this;
+        copy += rhs;
+
+        return copy;
+    }
+
+    Polynomial operator-(const Polynomial& rhs) const {
+        Polynomial copy = *this;
+        copy -= rhs;
+
+        return copy;
+    }
+
+    Polynomial operator*(const Polynomial& rhs) const {
+        Polynomial copy = *this;
+        copy *= rhs;
+
+        return copy;
+    }
+
+    Polynomial operator/(const Polynomial& rhs) const {
+        return divide(rhs).first;
+    }
+
+    Polynomial operator%(const Polynomial& rhs) const {
+        return divide(rhs).second;
+    }
+
+    bool operator==(const Polynomial& rhs) const {
+        return coefficients_ == rhs.coefficients_;
+    }
+
+    bool operator!=(const Polynomial& rhs) const {
+        return !(*this == rhs);
+    }
+
+    Polynomial getPrefix(size_t length) const {
+        Polynomial copy;
+        copy.coefficients_.assign(coefficients_.begin(), coefficients_.begin() + std::min(length, coefficients_.size()));
+        copy.Trim();
+
+        return copy;
+    }
+
+    Polynomial reversed(size_t length) const {
+        std::vector<Residue<N>> coefficients(length, 0);
+        for (size_t i = 0; i < length && i < coefficients_.size(); ++i) {
+            coefficients[length - 1 - i] = coefficients_[i];
+        }
+
+        return Polynomial(coefficients);
+    }
+
+    Polynomial derivative() const {
+        std::vector<Residue<N>> coefficients;
+        for (size_t i = 1; i < coefficients_.size(); ++i) {
+            coefficients.push_back(coefficients_[i] * Residue<N>(static_cast<int>(i)));
+        }
+
+        return Polynomial(coefficients);
+    }
+
+    Polynomial inverted(size_t length) const {
+        if (coefficients_.empty() || coefficients_[0] == 0) {
+            throw std::invalid_argument("NOT INVERTIBLE");
+        }
+
+        Polynomial inverse = coefficients_[0].inverted();
+        for (size_t current = 1; current < length; current <<= 1) {
+            Polynomial correction = (getPrefix(2 * current) * inverse).getPrefix(2 * current);
+            correction = Polynomial(Residue<N>(2)) - correction;
+            inverse = (inverse * correction).getPrefix(2 * current);
+        }
+
+        return inverse.getPrefix(length);
+    }
+
+    std::pair<Polynomial, Polynomial> divide(const Polynomial& rhs) const {
+        if (rhs.coefficients_.empty()) {
+            throw std::invalid_argument("DIVISION BY ZERO");
+        }
+        if (coefficients_.size() < rhs.coefficients_.size()) {
+            return {Polynomial(), *this};
+        }
+
+        size_t quotient_size = coefficients_.size() - rhs.coefficients_.size() + 1;
+        Polynomial quotient;
+        if (rhs.coefficients_.size() <= naive_threshold_ || quotient_size <= naive_threshold_) {
+            quotient = divideNaive(rhs);
+        } else {
+            Polynomial reversed_quotient = reversed(coefficients_.size()) *
+                                           rhs.reversed(rhs.coefficients_.size()).inverted(quotient_size);
+            quotient = reversed_quotient.getPrefix(quotient_size).reversed(quotient_size);
+        }
+
+        return {quotient, *this - rhs * quotient};
+    }
+
+    Residue<N> evaluate(const Residue<N>& point) const {
+        Residue<N> value = 0;
+        for (size_t i = coefficients_.size(); i > 0; --i) {
+            value *= point;
+            value += coefficients_[i - 1];
+        }
+
+        return value;
+    }
+
+    std::vector<Residue<N>> evaluate(const std::vector<Residue<N>>& points) const {
+        std::vector<Residue<N>> values(points.size());
+        if (points.empty()) {
+            return values;
+        }
+
+        std::vector<Polynomial> tree(4 * points.size());
+        buildTree(tree, points, 1, 0, points.size());
+        evaluateTree(tree, *this % tree[1], points, values, 1, 0, points.size());
+
+        return values;
+    }
+
+    static Polynomial interpolate(const std::vector<Residue<N>>& points, const std::vector<Residue<N>>& values) {
+        if (points.size() != values.size()) {
+            throw std::invalid_argument("SIZE MISMATCH");
+        }
+        if (points.empty()) {
+            return Polynomial();
+        }
+
+        std::vector<Polynomial> tree(4 * points.size());
+        buildTree(tree, points, 1, 0, points.size());
+
+        std::vector<Residue<N>> weights = tree[1].derivative().evaluate(points);
+        invertAll(weights);
+        for (size_t i = 0; i < weights.size(); ++i) {
+            weights[i] *= values[i];
+        }
+
+        return combineTree(tree, weights, 1, 0, points.size());
+    }
+
+private:
+    static const size_t naive_threshold_ = 32;
+    static const size_t max_transform_log_ = getTwoAdicity(N - 1);
+    static const bool has_transform_ = (static_cast<size_t>(1) << max_transform_log_) > 2 * naive_threshold_;
+    static const bool has_shoup_transform_ = N < (static_cast<size_t>(1) << 31);
+    static const uint32_t shoup_modulo_ = static_cast<uint32_t>(N);
+
+    void Trim() {
+        while (!coefficients_.empty() && coefficients_.back() == 0) {
+            coefficients_.pop_back();
+        }
+    }
+
+    void multiplyNaive(const Polynomial& rhs) {
+        std::vector<Residue<N>> product(coefficients_.size() + rhs.coefficients_.size() - 1, 0);
+        for (size_t i = 0; i < coefficients_.size(); ++i) {
+            for (size_t j = 0; j < rhs.coefficients_.size(); ++j) {
+                product[i + j] += coefficients_[i] * rhs.coefficients_[j];
+            }
+        }
+        coefficients_.swap(product);
+        Trim();
+    }
+
+    Polynomial divideNaive(const Polynomial& rhs) const {
+        std::vector<Residue<N>> remainder(coefficients_);
+        std::vector<Residue<N>> quotient(coefficients_.size() - rhs.coefficients_.size() + 1, 0);
+        Residue<N> leading_inverse = rhs.coefficients_.back().inverted();
+        for (size_t i = quotient.size(); i > 0; --i) {
+            Residue<N> koef = remainder[i - 1 + rhs.coefficients_.size() - 1] * leading_inverse;
+            quotient[i - 1] = koef;
+            for (size_t j = 0; j < rhs.coefficients_.size(); ++j) {
+                remainder[i - 1 + j] -= rhs.coefficients_[j] * koef;
+            }
+        }
+
+        return Polynomial(quotient);
+    }
+
+    template <typename Value>
+    static void reverseBits(std::vector<Value>& values) {
+        size_t size = values.size();
+        for (size_t i = 1, j = 0; i < size; ++i) {
+            size_t bit = size >> 1;
+            for (; j & bit; bit >>= 1) {
+                j ^= bit;
+            }
+            j ^= bit;
+            if (i < j) {
+                std::swap(values[i], values[j]);
+            }
+        }
+    }
+
+    static void transform(std::vector<Residue<N>>& values, bool is_inverse) {
+        if constexpr (has_shoup_transform_) {
+            transformShoup(values, is_inverse);
+            return;
+        }
+
+        size_t size = values.size();
+        reverseBits(values);
+
+        std::vector<Residue<N>> twiddles(size / 2 + 1);
+        for (size_t length = 1, level = 1; length < size; length <<= 1, ++level) {
+            Residue<N> root = is_inverse ? root_table<N>.inverse_roots[level] : root_table<N>.roots[level];
+            twiddles[0] = 1;
+            for (size_t k = 1; k < length; ++k) {
+                twiddles[k] = twiddles[k - 1] * root;
+            }
+
+            for (size_t start = 0; start < size; start += 2 * length) {
+                Residue<N>* lower = values.data() + start;
+                Residue<N>* upper = lower + length;
+                for (size_t k = 0; k < length; ++k) {
+                    Residue<N> product = upper[k] * twiddles[k];
+                    upper[k] = lower[k] - product;
+                    lower[k] += product;
+                }
+            }
+        }
+
+        if (is_inverse) {
+            Residue<N> size_inverse = Residue<N>(static_cast<int>(size)).inverted();
+            for (size_t i = 0; i < size; ++i) {
+                values[i] *= size_inverse;
+            }
+        }
+    }
+
+    static void transformShoup(std::vector<Residue<N>>& values, bool is_inverse) {
+        size_t size = values.size();
+        std::vector<uint32_t> lanes(size);
+        for (size_t i = 0; i < size; ++i) {
+            lanes[i] = static_cast<uint32_t>(values[i].getValue());
+        }
+        reverseBits(lanes);
+
+        size_t top_level = 0;
+        while ((static_cast<size_t>(1) << top_level) < size) {
+            ++top_level;
+        }
+
+        std::vector<uint32_t> twiddles(size);
+        std::vector<uint32_t> twiddle_quotients(size);
+        Residue<N> root = is_inverse ? root_table<N>.inverse_roots[top_level] : root_table<N>.roots[top_level];
+        Residue<N> twiddle = 1;
+        for (size_t k = size / 2; k < size; ++k) {
+            twiddles[k] = static_cast<uint32_t>(twiddle.getValue());
+            twiddle *= root;
+        }
+        for (size_t k = size / 2; k-- > 1;) {
+            twiddles[k] = twiddles[2 * k];
+        }
+        for (size_t k = 1; k < size; ++k) {
+            twiddle_quotients[k] = static_cast<uint32_t>((static_cast<uint64_t>(twiddles[k]) << 32) / N);
+        }
+
+        for (size_t length = 1; length < size; length <<= 1) {
+            const uint32_t* stage_twiddles = twiddles.data() + length;
+            const uint32_t* stage_quotients = twiddle_quotients.data() + length;
+            for (size_t start = 0; start < size; start += 2 * length) {
+                uint32_t* lower = lanes.data() + start;
+                uint32_t* upper = lower + length;
+                for (size_t k = 0; k < length; ++k) {
+                    uint32_t quotient = static_cast<uint32_t>((static_cast<uint64_t>(upper[k]) * stage_quotients[k]) >> 32);
+                    uint32_t product = upper[k] * stage_twiddles[k] - quotient * shoup_modulo_;
+                    product = product >= shoup_modulo_ ? product - shoup_modulo_ : product;
+                    uint32_t sum = lower[k] + product;
+                    uint32_t difference = lower[k] + shoup_modulo_ - product;
+                    lower[k] = sum >= shoup_modulo_ ? sum - shoup_modulo_ : sum;
+                    upper[k] = difference >= shoup_modulo_ ? difference - shoup_modulo_ : difference;
+                }
+            }
+        }
+
+        Residue<N> scale = is_inverse ? Residue<N>(static_cast<int>(size)).inverted() : Residue<N>(1);
+        for (size_t i = 0; i < size; ++i) {
+            values[i] = Residue<N>(static_cast<int>(lanes[i])) * scale;
+        }
+    }
+
+    static void buildTree(std::vector<Polynomial>& tree, const std::vector<Residue<N>>& points,
+                          size_t node, size_t left, size_t right) {
+        if (right - left == 1) {
+            tree[node] = Polynomial({Residue<N>(0) - points[left], Residue<N>(1)});
+            return;
+        }
+
+        size_t middle = (left + right) / 2;
+        buildTree(tree, points, 2 * node, left, middle);
+        buildTree(tree, points, 2 * node + 1, middle, right);
+        tree[node] = tree[2 * node] * tree[2 * node + 1];
+    }
+
+    static void evaluateTree(const std::vector<Polynomial>& tree, const Polynomial& remainder,
+                             const std::vector<Residue<N>>& points, std::vector<Residue<N>>& values,
+                             size_t node, size_t left, size_t right) {
+        if (right - left <= naive_threshold_) {
+            for (size_t i = left; i < right; ++i) {
+                values[i] = remainder.evaluate(points[i]);
+            }
+            return;
+        }
+
+        size_t middle = (left + right) / 2;
+        evaluateTree(tree, remainder % tree[2 * node], points, values, 2 * node, left, middle);
+        evaluateTree(tree, remainder % tree[2 * node + 1], points, values, 2 * node + 1, middle, right);
+    }
+
+    static Polynomial combineTree(const std::vector<Polynomial>& tree, const std::vector<Residue<N>>& weights,
+                                  size_t node, size_t left, size_t right) {
+        if (right - left == 1) {
+            return Polynomial(weights[left]);
+        }
+
+        size_t middle = (left + right) / 2;
+        return combineTree(tree, weights, 2 * node, left, middle) * tree[2 * node + 1] +
+               combineTree(tree, weights, 2 * node + 1, middle, right) * tree[2 * node];
+    }
+
+    std::vector<Residue<N>> coefficients_;
+};
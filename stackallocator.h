@@ -1,112 +1,394 @@
+#include <atomic>
+#include <cstddef>
 #include <iostream>
 #include <iterator>
+#include <memory>
+#include <new>
 
 template <size_t N>
 class StackStorage {
+private:
+    struct Chunk;
+
 public:
+    struct Marker;
+
     StackStorage();
     StackStorage(const StackStorage& other) = delete;
-    uint8_t* allocate(size_t shift, size_t number_of_memory);
+    StackStorage& operator=(const StackStorage& other) = delete;
+    ~StackStorage();
+
+    uint8_t* allocate(size_t number_of_memory, size_t alignment);
+    void deallocate(uint8_t* pointer, size_t number_of_memory, size_t alignment);
+    Marker mark() const;
+    void release(const Marker& marker);
     size_t getAddress() const;
+    size_t getUsedMemory() const;
+    size_t getHighWaterMark() const;
+    size_t getOverflowCount() const;
 
 private:
+    void AllocateChunk(size_t number_of_memory, size_t alignment);
+
     uint8_t memory_ [N];
     uint8_t* pointer_to_free_memory_;
+    uint8_t* end_of_memory_;
+    Chunk* chunk_;
+    size_t used_memory_;
+    size_t high_water_mark_;
+    size_t overflow_count_;
+};
+
+template <size_t N>
+struct StackStorage<N>::Chunk {
+    Chunk* previous;
+    size_t capacity;
 };
 
 template <size_t N>
-StackStorage<N>::StackStorage(): pointer_to_free_memory_(memory_) {}
+struct StackStorage<N>::Marker {
+    uint8_t* pointer_to_free_memory;
+    uint8_t* end_of_memory;
+    Chunk* chunk;
+    size_t used_memory;
+};
+
+template <size_t N>
+StackStorage<N>::StackStorage(): pointer_to_free_memory_(memory_),
+                                 end_of_memory_(memory_ + N),
+                                 chunk_(nullptr),
+                                 used_memory_(0),
+                                 high_water_mark_(0),
+                                 overflow_count_(0) {}
+
+template <size_t N>
+StackStorage<N>::~StackStorage() {
+    while (chunk_ != nullptr) {
+        Chunk* previous = chunk_->previous;
+        delete[] reinterpret_cast<uint8_t*>(chunk_);
+        chunk_ = previous;
+    }
+}
 
 template <size_t N>
-uint8_t* StackStorage<N>::allocate(size_t shift, size_t number_of_memory) {
+uint8_t* StackStorage<N>::allocate(size_t number_of_memory, size_t alignment) {
+    size_t shift = (alignment - getAddress() % alignment) % alignment;
+    if (static_cast<size_t>(end_of_memory_ - pointer_to_free_memory_) < shift + number_of_memory) {
+        AllocateChunk(number_of_memory, alignment);
+        shift = (alignment - getAddress() % alignment) % alignment;
+    }
+
     uint8_t* pointer_to_chunk = pointer_to_free_memory_ + shift;
     pointer_to_free_memory_ += number_of_memory + shift;
+    used_memory_ += number_of_memory + shift;
+    if (used_memory_ > high_water_mark_) {
+        high_water_mark_ = used_memory_;
+    }
+
     return pointer_to_chunk;
 }
 
+template <size_t N>
+void StackStorage<N>::deallocate(uint8_t* pointer, size_t number_of_memory, size_t) {
+    if (pointer + number_of_memory == pointer_to_free_memory_) {
+        pointer_to_free_memory_ = pointer;
+        used_memory_ -= number_of_memory;
+    }
+}
+
+template <size_t N>
+typename StackStorage<N>::Marker StackStorage<N>::mark() const {
+    return Marker{pointer_to_free_memory_, end_of_memory_, chunk_, used_memory_};
+}
+
+template <size_t N>
+void StackStorage<N>::release(const Marker& marker) {
+    while (chunk_ != marker.chunk) {
+        Chunk* previous = chunk_->previous;
+        delete[] reinterpret_cast<uint8_t*>(chunk_);
+        chunk_ = previous;
+    }
+
+    pointer_to_free_memory_ = marker.pointer_to_free_memory;
+    end_of_memory_ = marker.end_of_memory;
+    used_memory_ = marker.used_memory;
+}
+
+template <size_t N>
+void StackStorage<N>::AllocateChunk(size_t number_of_memory, size_t alignment) {
+    size_t capacity = chunk_ == nullptr ? 2 * N : 2 * chunk_->capacity;
+    if (capacity < number_of_memory + alignment) {
+        capacity = number_of_memory + alignment;
+    }
+
+    Chunk* chunk = reinterpret_cast<Chunk*>(new uint8_t[sizeof(Chunk) + capacity]);
+    chunk->previous = chunk_;
+    chunk->capacity = capacity;
+    chunk_ = chunk;
+
+    pointer_to_free_memory_ = reinterpret_cast<uint8_t*>(chunk + 1);
+    end_of_memory_ = pointer_to_free_memory_ + capacity;
+    ++overflow_count_;
+}
+
 template <size_t N>
 size_t StackStorage<N>::getAddress() const {
     return reinterpret_cast<size_t>(pointer_to_free_memory_);
 }
 
-template <typename T, size_t N>
+template <size_t N>
+size_t StackStorage<N>::getUsedMemory() const {
+    return used_memory_;
+}
+
+template <size_t N>
+size_t StackStorage<N>::getHighWaterMark() const {
+    return high_water_mark_;
+}
+
+template <size_t N>
+size_t StackStorage<N>::getOverflowCount() const {
+    return overflow_count_;
+}
+
+template <size_t N>
+class PoolStorage {
+public:
+    PoolStorage();
+    PoolStorage(const PoolStorage& other) = delete;
+    PoolStorage& operator=(const PoolStorage& other) = delete;
+
+    uint8_t* allocate(size_t number_of_memory, size_t alignment);
+    void deallocate(uint8_t* pointer, size_t number_of_memory, size_t alignment);
+    size_t getUsedMemory() const;
+    StackStorage<N>& getStorage();
+
+private:
+    struct Slot;
+
+    static const size_t slot_alignment_ = alignof(std::max_align_t);
+    static const size_t number_of_size_classes_ = 16;
+    static const size_t number_of_alignment_classes_ = 4;
+
+    static size_t GetSizeClass(size_t number_of_memory);
+    static size_t GetAlignmentClass(size_t alignment);
+
+    StackStorage<N> storage_;
+    Slot* free_lists_[number_of_alignment_classes_][number_of_size_classes_];
+    size_t used_memory_;
+};
+
+template <size_t N>
+struct PoolStorage<N>::Slot {
+    Slot* next;
+};
+
+template <size_t N>
+PoolStorage<N>::PoolStorage(): free_lists_(), used_memory_(0) {}
+
+template <size_t N>
+uint8_t* PoolStorage<N>::allocate(size_t number_of_memory, size_t alignment) {
+    size_t size_class = GetSizeClass(number_of_memory);
+    size_t alignment_class = GetAlignmentClass(alignment);
+    if (size_class >= number_of_size_classes_ || alignment_class >= number_of_alignment_classes_) {
+        used_memory_ += number_of_memory;
+        return storage_.allocate(number_of_memory, alignment);
+    }
+
+    size_t slot_size = (size_class + 1) * slot_alignment_;
+    used_memory_ += slot_size;
+    Slot*& free_list = free_lists_[alignment_class][size_class];
+    if (free_list == nullptr) {
+        return storage_.allocate(slot_size, slot_alignment_ << alignment_class);
+    }
+
+    Slot* slot = free_list;
+    free_list = slot->next;
+    return reinterpret_cast<uint8_t*>(slot);
+}
+
+template <size_t N>
+void PoolStorage<N>::deallocate(uint8_t* pointer, size_t number_of_memory, size_t alignment) {
+    size_t size_class = GetSizeClass(number_of_memory);
+    size_t alignment_class = GetAlignmentClass(alignment);
+    if (size_class >= number_of_size_classes_ || alignment_class >= number_of_alignment_classes_) {
+        used_memory_ -= number_of_memory;
+        storage_.deallocate(pointer, number_of_memory, alignment);
+        return;
+    }
+
+    used_memory_ -= (size_class + 1) * slot_alignment_;
+    Slot*& free_list = free_lists_[alignment_class][size_class];
+    Slot* slot = reinterpret_cast<Slot*>(pointer);
+    slot->next = free_list;
+    free_list = slot;
+}
+
+template <size_t N>
+size_t PoolStorage<N>::getUsedMemory() const {
+    return used_memory_;
+}
+
+template <size_t N>
+StackStorage<N>& PoolStorage<N>::getStorage() {
+    return storage_;
+}
+
+template <size_t N>
+size_t PoolStorage<N>::GetSizeClass(size_t number_of_memory) {
+    return number_of_memory == 0 ? 0 : (number_of_memory - 1) / slot_alignment_;
+}
+
+template <size_t N>
+size_t PoolStorage<N>::GetAlignmentClass(size_t alignment) {
+    size_t alignment_class = 0;
+    while (alignment_class < number_of_alignment_classes_ && (slot_alignment_ << alignment_class) < alignment) {
+        ++alignment_class;
+    }
+    return alignment_class;
+}
+
+template <size_t N>
+class SharedStackStorage {
+public:
+    SharedStackStorage();
+    SharedStackStorage(const SharedStackStorage& other) = delete;
+    SharedStackStorage& operator=(const SharedStackStorage& other) = delete;
+
+    uint8_t* allocate(size_t number_of_memory, size_t alignment);
+    void deallocate(uint8_t* pointer, size_t number_of_memory, size_t alignment);
+    size_t getUsedMemory() const;
+
+private:
+    uint8_t memory_ [N];
+    std::atomic<size_t> used_memory_;
+};
+
+template <size_t N>
+SharedStackStorage<N>::SharedStackStorage(): used_memory_(0) {}
+
+template <size_t N>
+uint8_t* SharedStackStorage<N>::allocate(size_t number_of_memory, size_t alignment) {
+    size_t used_memory = used_memory_.load(std::memory_order_relaxed);
+    size_t shift;
+    do {
+        shift = (alignment - reinterpret_cast<size_t>(memory_ + used_memory) % alignment) % alignment;
+        if (N - used_memory < shift + number_of_memory) {
+            throw std::bad_alloc();
+        }
+    } while (!used_memory_.compare_exchange_weak(used_memory, used_memory + shift + number_of_memory,
+                                                 std::memory_order_acquire, std::memory_order_relaxed));
+
+    return memory_ + used_memory + shift;
+}
+
+template <size_t N>
+void SharedStackStorage<N>::deallocate(uint8_t* pointer, size_t number_of_memory, size_t) {
+    size_t used_memory = static_cast<size_t>(pointer - memory_) + number_of_memory;
+    used_memory_.compare_exchange_strong(used_memory, static_cast<size_t>(pointer - memory_),
+                                         std::memory_order_release, std::memory_order_relaxed);
+}
+
+template <size_t N>
+size_t SharedStackStorage<N>::getUsedMemory() const {
+    return used_memory_.load(std::memory_order_relaxed);
+}
+
+template <typename Storage>
+Storage& getThreadLocalStorage() {
+    thread_local std::unique_ptr<Storage> storage;
+    if (storage == nullptr) {
+        storage.reset(new Storage());
+    }
+
+    return *storage;
+}
+
+template <typename T, size_t N, typename Storage = StackStorage<N>>
 class StackAllocator {
 public:
     using value_type = T;
 
-    explicit StackAllocator(StackStorage<N>& memory);
+    StackAllocator();
+    explicit StackAllocator(Storage& memory);
 
     template <typename U>
-    StackAllocator(const StackAllocator<U, N>& other);
+    StackAllocator(const StackAllocator<U, N, Storage>& other);
 
     template <typename U>
-    StackAllocator<T, N>& operator=(const StackAllocator<U, N>& other);
+    StackAllocator<T, N, Storage>& operator=(const StackAllocator<U, N, Storage>& other);
 
     T* allocate(size_t number_of_elements);
-    void deallocate(T*, size_t);
+    void deallocate(T* pointer, size_t number_of_elements);
 
     template <typename U>
     struct rebind;
 
     template <typename U>
-    bool operator==(const StackAllocator<U, N>& rhs);
+    bool operator==(const StackAllocator<U, N, Storage>& rhs);
 
     template <typename U>
-    bool operator!=(const StackAllocator<U, N>& lhs);
+    bool operator!=(const StackAllocator<U, N, Storage>& lhs);
 
-    StackStorage<N>* getStorage() const;
+    Storage* getStorage() const;
 
 private:
-    StackStorage<N>* memory_;
+    Storage* memory_;
 };
 
-template <typename T, size_t N>
-StackAllocator<T, N>::StackAllocator(StackStorage<N>& memory): memory_(&memory){}
+template <typename T, size_t N, typename Storage>
+StackAllocator<T, N, Storage>::StackAllocator(): memory_(&getThreadLocalStorage<Storage>()) {}
 
-template <typename T, size_t N>
+template <typename T, size_t N, typename Storage>
+StackAllocator<T, N, Storage>::StackAllocator(Storage& memory): memory_(&memory){}
+
+template <typename T, size_t N, typename Storage>
 template <typename U>
-StackAllocator<T, N>::StackAllocator(const StackAllocator<U, N>& other): memory_(other.getStorage()) {}
+StackAllocator<T, N, Storage>::StackAllocator(const StackAllocator<U, N, Storage>& other): memory_(other.getStorage()) {}
 
-template <typename T, size_t N>
+template <typename T, size_t N, typename Storage>
 template <typename U>
-StackAllocator<T, N>& StackAllocator<T, N>::operator=(const StackAllocator<U, N>& other) {
+StackAllocator<T, N, Storage>& StackAllocator<T, N, Storage>::operator=(const StackAllocator<U, N, Storage>& other) {
     memory_ = other.getStorage();
     return *this;
 }
 
-template <typename T, size_t N>
-T* StackAllocator<T, N>::allocate(size_t number_of_elements) {
-    size_t modulo = (alignof(T) - memory_->getAddress() % alignof(T)) % alignof(T);
-    alignas(alignof(T)) T* chunk_of_memory = reinterpret_cast<T*>(memory_->allocate(modulo, number_of_elements * sizeof(T)));
-    return chunk_of_memory;
+template <typename T, size_t N, typename Storage>
+T* StackAllocator<T, N, Storage>::allocate(size_t number_of_elements) {
+    return reinterpret_cast<T*>(memory_->allocate(number_of_elements * sizeof(T), alignof(T)));
 }
 
-template <typename T, size_t N>
-void StackAllocator<T, N>::deallocate(T*, size_t) {}
+template <typename T, size_t N, typename Storage>
+void StackAllocator<T, N, Storage>::deallocate(T* pointer, size_t number_of_elements) {
+    memory_->deallocate(reinterpret_cast<uint8_t*>(pointer), number_of_elements * sizeof(T), alignof(T));
+}
 
-template <typename T, size_t N>
+template <typename T, size_t N, typename Storage>
 template <typename U>
-struct StackAllocator<T, N>::rebind {
-    using other = StackAllocator<U, N>;
+struct StackAllocator<T, N, Storage>::rebind {
+    using other = StackAllocator<U, N, Storage>;
 };
 
-template <typename T, size_t N>
+template <typename T, size_t N, typename Storage>
 template <typename U>
-bool StackAllocator<T, N>::operator==(const StackAllocator<U, N>& rhs) {
+bool StackAllocator<T, N, Storage>::operator==(const StackAllocator<U, N, Storage>& rhs) {
     return memory_ == rhs.getStorage();
 }
 
-template <typename T, size_t N>
+template <typename T, size_t N, typename Storage>
 template <typename U>
-bool StackAllocator<T, N>::operator!=(const StackAllocator<U, N>& rhs) {
+bool StackAllocator<T, N, Storage>::operator!=(const StackAllocator<U, N, Storage>& rhs) {
     return !(*this == rhs);
 }
 
-template <typename T, size_t N>
-StackStorage<N>* StackAllocator<T, N>::getStorage() const {
+template <typename T, size_t N, typename Storage>
+Storage* StackAllocator<T, N, Storage>::getStorage() const {
     return memory_;
 }
 
+template <typename T, size_t N>
+using PoolAllocator = StackAllocator<T, N, PoolStorage<N>>;
+
 template <typename T, typename Allocator = std::allocator<T>>
 class List {
 private: